@@ -27,11 +27,248 @@ static const uint8_t SIEVE_PRIMES[NUM_SIEVE_PRIMES] = {
 /* Maximum prime value (for array sizing) */
 #define MAX_PRIME 71
 
+/* Configurable sieve moduli (primes or prime powers, see --moduli).
+ * Every modulus must fit the byte tables, the 128-bit residue masks and the
+ * AVX2 byte lanes, hence the bound of 128. */
+#define MAX_SIEVE_MODULI 32
+#define MAX_SIEVE_MODULUS 128
+
+/* Moduli above MAX_SIEVE_MODULUS (up to 2^16) go to a "wide" tier with
+ * 16-bit residue tables and variable-width masks, tested per survivor of the
+ * byte tier. */
+#define MAX_WIDE_MODULI 64
+#define MAX_WIDE_MODULUS 65535
+
+/* Capacity of a combined (byte + wide) moduli list. */
+#define MAX_MODULI_LIST (MAX_SIEVE_MODULI + MAX_WIDE_MODULI)
+
+/* Periodic tail after each by_pow row so vector kernels can load a full
+ * 32-lane block starting at any residue. */
+#define SIEVE_LANE_PAD 32
+
+/* Words per periodic B-survivor pattern: bits [0, m + 64) must be stored so
+ * any 64-bit window starting below m can be extracted (m <= 128). */
+#define PATTERN_WORDS 3
+
+/* Maximum number of CRT-fused prime groups (see FusedGroup). */
+#define MAX_FUSED_GROUPS 4
+
+/* B values per block in the row-bitmap sieve (64 words of 64 bits). */
+#define SIEVE_ROW_WORDS 64
+#define SIEVE_ROW_BLOCK (SIEVE_ROW_WORDS * 64)
+
+/* Non-fused moduli (first in the test order) in the tiered sieve's bitmap
+ * prefilter; the rest run on the compacted survivors. */
+#define SIEVE_TIER1_MODULI 4
+
+/* Prefix-pattern cache bounds (see PrefixCache): combined period and total
+ * pattern memory. */
+#define MAX_PREFIX_PERIOD 32768
+#define MAX_PREFIX_CACHE_BYTES (4u << 20)
+
+/* The prefix cache is built only when the word ANDs it saves over the sweep
+ * are at least this many times the word operations that build it. */
+#define PREFIX_MIN_GAIN 8
+
+/* Largest residue-class wheel modulus (see SieveWheel). */
+#define MAX_WHEEL_MODULUS 4096
+
+/* Deep bank: extra primes (up to MAX_WIDE_MODULUS) tested only on sieve
+ * survivors, just before GMP. */
+#define MAX_DEEP_PRIMES 1024
+#define DEEP_BANK_DEFAULT 256
+
+/* Euler-criterion filter: 61-bit primes q = 1 (mod z) checked with
+ * Montgomery arithmetic before GMP. */
+#define MAX_EULER_PRIMES 8
+#define EULER_FILTER_DEFAULT 4
+
+/* Most signatures (x, y, z_k) in one z-family run; bit k of a family
+ * survivor mask stands for z_k. */
+#define MAX_Z_FAMILY 8
+
+/* Distinct primes of a 64-bit integer (2 * 3 * ... * 47 < 2^64) */
+#define MAX_DISTINCT_PRIMES 15
+
+/* Largest A covered by the smallest-prime-factor table (2 bytes per A of
+ * the window); rows beyond it are factored by trial division */
+#define FACTOR_TABLE_LIMIT (1u << 24)
+
 /* ============================================================================
  * DATA STRUCTURES
  * ============================================================================
  */
 
+/**
+ * Barrett constant for reducing 64-bit values modulo m < 2^32, see
+ * barrett64_reduce().
+ */
+typedef struct {
+  uint64_t m;
+  uint64_t mu; /* floor((2^64 - 1) / m) */
+} Barrett64;
+
+/**
+ * A group of small sieve moduli fused into one composite modulus
+ * M = lcm(m1, m2, ...) (e.g. 2*3*5*7 = 210). By CRT, A mod M and B mod M
+ * determine A and B modulo every member, so one 2D bitmap over
+ * (A mod M, B mod M) replaces all of the group's per-modulus tests.
+ */
+typedef struct {
+  uint32_t modulus;     /* M */
+  uint32_t member_mask; /* Bit i set iff moduli[i] is in the group */
+  uint32_t row_words;  /* Words per row: bits [0, M + 64) are stored */
+
+  /* rows[(A mod M) * row_words ...]: bit k set iff a pair with
+   * B = k (mod M) survives every member of the group. Periodic tail past M so
+   * the row-bitmap sieve can take 64-bit windows directly. */
+  uint64_t *rows;
+
+  Barrett64 reduce; /* A mod M, B mod M */
+} FusedGroup;
+
+/**
+ * A sieve modulus above MAX_SIEVE_MODULUS, with 16-bit residue tables.
+ */
+typedef struct {
+  uint32_t modulus;
+  uint32_t mask_words;     /* (modulus + 63) / 64 */
+  uint64_t *residue_mask;  /* Bit r set iff r is a z-th power mod modulus */
+  uint16_t *pow;           /* pow[a] = a^x, pow[modulus + b] = b^y */
+  Barrett64 reduce;        /* A mod modulus, B mod modulus */
+} WideModulus;
+
+/**
+ * Memoized B-survivor patterns for a prefix of pairwise coprime byte-tier
+ * moduli with product P. A row's combined pattern depends only on the tuple
+ * (A^x mod m) over the members, and with gcd(x, m-1) > 1 those tuples are
+ * far fewer than the A rows, so one pattern of period P per distinct tuple
+ * is shared by every row that has it.
+ */
+typedef struct {
+  uint32_t period;      /* P (0 = no cache) */
+  uint32_t member_mask; /* Bit i set iff moduli[i] is a member */
+  int num_members;
+  uint32_t row_words; /* Words per pattern: bits [0, P + 64) are stored */
+  uint32_t num_keys;  /* Distinct residue tuples */
+
+  /* key(A) = sum over members of stride[i] * digit[i][A^x mod moduli[i]] */
+  uint32_t stride[MAX_SIEVE_MODULI];
+  uint8_t digit[MAX_SIEVE_MODULI][MAX_SIEVE_MODULUS];
+
+  uint64_t *patterns; /* [num_keys * row_words] */
+} PrefixCache;
+
+/**
+ * A read-only mapping of a precompute cache file (see cache.c); base is NULL
+ * for tables that were built in memory.
+ */
+typedef struct {
+  void *base;
+  size_t size;
+} CacheMap;
+
+/**
+ * One anonymous mapping holding a set of tables (see arena_alloc() in
+ * precompute.c). Pages are faulted in by whichever thread first writes them.
+ */
+typedef struct {
+  void *base;
+  size_t size;
+  bool huge; /* Advised onto transparent huge pages */
+} TableArena;
+
+/**
+ * A deep-bank prime. Tables are indexed by residue, not by A or B, so a bank
+ * of hundreds of primes stays a few MB regardless of the search range.
+ */
+typedef struct {
+  uint32_t modulus;
+  uint16_t *pow;          /* [2p]: pow[r] = r^x mod p, pow[p + r] = r^y mod p */
+  uint64_t *residue_mask; /* Bit r set iff r is a z-th power mod p */
+} DeepPrime;
+
+/**
+ * Second-tier bank of primes applied to the (rare) survivors of the sieve.
+ */
+typedef struct {
+  int count;
+  DeepPrime *primes; /* Best-filtering first */
+  CacheMap map;      /* Backing file of the tables, if mapped */
+  TableArena arena;  /* Backing store of the tables, if built */
+} DeepBank;
+
+/**
+ * Montgomery constants for an odd modulus q < 2^63 (R = 2^64), see
+ * mont64_init().
+ */
+typedef struct {
+  uint64_t q;
+  uint64_t q_neg_inv; /* -q^-1 mod 2^64 */
+  uint64_t r2;        /* R^2 mod q */
+  uint64_t one;       /* R mod q (1 in Montgomery form) */
+} Montgomery64;
+
+/**
+ * One Euler-filter prime q < 2^61.
+ */
+typedef struct {
+  Montgomery64 mont;
+  uint64_t exponent; /* (q - 1) / z */
+} EulerPrime;
+
+/**
+ * Euler-criterion z-th power residue filter (see euler_filter_init()).
+ */
+typedef struct {
+  int count;
+  EulerPrime primes[MAX_EULER_PRIMES];
+} EulerFilter;
+
+/**
+ * Two-dimensional residue-class wheel over W = product of pairwise coprime
+ * byte-tier moduli. Whether a pair survives every member, and whether the
+ * pair shares a member prime, depends only on (A mod W, B mod W); the live
+ * B classes for each A class are stored in CSR form.
+ */
+typedef struct {
+  uint32_t modulus;     /* W (0 = no wheel) */
+  uint32_t member_mask; /* Bit i set iff moduli[i] divides W */
+  uint32_t *offsets;    /* [W + 1]: live classes of a are */
+  uint16_t *classes;    /*   classes[offsets[a] .. offsets[a + 1]) */
+  CacheMap map;         /* Backing file of offsets/classes, if mapped */
+} SieveWheel;
+
+/**
+ * Smallest-prime-factor table for factoring A rows; built by
+ * precompute_build_factors(). spf[n - base] is the least prime factor of
+ * composite n in [base, limit], and 0 for primes (and n < 2). Every
+ * composite n < 2^24 has one below 2^12, so 16 bits suffice.
+ */
+typedef struct {
+  uint32_t base;  /* First A covered */
+  uint32_t limit; /* Last A covered (0 = no table) */
+  uint16_t *spf;
+  TableArena arena;
+} FactorTable;
+
+/**
+ * Tables for a z-family run: signatures (x, y, z[k]) share x and y, so the
+ * A^x + B^y residues are computed once per pair and only the residue sets
+ * differ. ok[i][s] packs membership of s in every family member's set.
+ */
+typedef struct {
+  int count; /* Signatures (0 = no family) */
+  uint32_t z[MAX_Z_FAMILY];
+
+  /* Bit k of ok[i][s] set iff s is a z[k]-th power mod moduli[i] */
+  uint8_t ok[MAX_SIEVE_MODULI][MAX_SIEVE_MODULUS];
+  uint64_t residue_masks[MAX_Z_FAMILY][MAX_SIEVE_MODULI][2];
+  uint8_t *wide_ok[MAX_WIDE_MODULI]; /* [wide[w].modulus], as ok[] */
+
+  DeepBank deep[MAX_Z_FAMILY]; /* Deep bank ranked for each z[k] */
+} ZFamily;
+
 /**
  * Precomputed residue data for a signature (x, y, z).
  * This allows O(1) lookup during the hot sieve loop.
@@ -39,19 +276,77 @@ static const uint8_t SIEVE_PRIMES[NUM_SIEVE_PRIMES] = {
 typedef struct {
   uint32_t x, y, z; /* Signature exponents */
 
-  /* Residue sets: for each prime p, which residues are z-th powers mod p?
-   * Stored as 128-bit bitmask (2x64) to support primes up to 127.
+  /* Sieve moduli (SIEVE_PRIMES by default; prime powers allowed) */
+  int num_moduli;
+  uint32_t moduli[MAX_SIEVE_MODULI];
+
+  /* Residue sets: for each modulus m, which residues are z-th powers mod m?
+   * Stored as 128-bit bitmask (2x64) to support moduli up to 128.
+   */
+  uint64_t residue_masks[MAX_SIEVE_MODULI][2];
+
+  /* A^x mod m and B^y mod m depend only on A mod m and B mod m, so the
+   * power tables are indexed by residue and their size is independent of
+   * the search range. ax_pow[i][a] = a^x mod m for a < m. by_pow[i] is
+   * periodic, by_pow[i][k] = (k mod m)^y mod m for k < m + SIEVE_LANE_PAD,
+   * so 32 consecutive B starting at B read by_pow[i] + B mod m. */
+  uint8_t ax_pow[MAX_SIEVE_MODULI][MAX_SIEVE_MODULUS];
+  uint8_t *by_pow[MAX_SIEVE_MODULI];
+  Barrett64 reduce[MAX_SIEVE_MODULI]; /* v mod moduli[i] */
+
+  /* Periodic B-survivor patterns for the row-bitmap sieve.
+   * b_patterns[i][a * PATTERN_WORDS + ...] has bit k set iff a B with
+   * B = k (mod m) survives modulus m when A^x = a (mod m), for k < m + 64.
    */
-  uint64_t residue_masks[NUM_SIEVE_PRIMES][2];
+  uint64_t *b_patterns[MAX_SIEVE_MODULI];
 
-  /* Precomputed A^x mod p and B^y mod p for all A, B in search range.
-   * ax_mod is A-major: [A][prime_idx] (efficient for fixed A)
-   * by_mod is Prime-major: [prime_idx][B] (efficient for SIMD B-sweeps)
+  /* Transposed patterns for the bit-sliced sieve: a_patterns[i][v *
+   * PATTERN_WORDS + ...] has bit k set iff an A with A = k (mod m) survives
+   * modulus m when B^y = v (mod m), for k < m + 64.
    */
-  uint8_t **ax_mod; /* ax_mod[A][prime_idx] */
-  uint8_t **by_mod; /* by_mod[prime_idx][B] */
+  uint64_t *a_patterns[MAX_SIEVE_MODULI];
 
-  uint64_t A_max, B_max; /* Search bounds */
+  /* Optional CRT-fused groups, tested before the remaining moduli.
+   * Empty unless precompute_build_fused() was called. */
+  int num_fused;
+  uint32_t fused_mask; /* Union of the groups' member_mask */
+  FusedGroup fused[MAX_FUSED_GROUPS];
+
+  /* Wide tier: moduli > MAX_SIEVE_MODULUS, tested after the byte tier */
+  int num_wide;
+  WideModulus wide[MAX_WIDE_MODULI];
+
+  /* Test order within each tier (indices into moduli[] / wide[]).
+   * Identity after precompute; sieve_profile_order() reorders by measured
+   * kill rate. Fused members keep their slots but are skipped. */
+  uint8_t order[MAX_SIEVE_MODULI];
+  uint8_t wide_order[MAX_WIDE_MODULI];
+
+  /* Optional prefix-pattern cache; built by precompute_build_prefix() */
+  PrefixCache prefix;
+
+  /* Optional residue-class wheel; built by precompute_build_wheel() */
+  SieveWheel wheel;
+
+  /* Optional deep bank; built by precompute_build_deep() */
+  DeepBank deep;
+
+  /* Optional z-family tables; built by precompute_build_family() */
+  ZFamily family;
+
+  /* Optional A factor table; built by precompute_build_factors() */
+  FactorTable factors;
+
+  /* Backing store of by_pow, the patterns and the wide-tier tables */
+  TableArena arena;
+
+  /* Directory of the on-disk cache for the wheel and deep banks, or NULL */
+  const char *cache_dir;
+
+  /* Search window; the tables above do not depend on it, only the masking
+   * of lanes past A_max and B_max does */
+  uint64_t A_start, A_max;
+  uint64_t B_start, B_max;
 } PrecomputedData;
 
 /**
@@ -71,6 +366,8 @@ typedef struct {
   uint64_t gcd_filtered;   /* Pairs skipped due to gcd(A,B) > 1 */
   uint64_t mod_filtered;   /* Pairs killed by sieve */
   uint64_t exact_checks;   /* Pairs that survived sieve (verified with GMP) */
+  uint64_t deep_filtered;  /* Of exact_checks: ruled out by the deep bank */
+  uint64_t euler_filtered; /* Of exact_checks: ruled out by Euler's test */
   uint64_t power_hits;     /* Pairs where A^x + B^y = C^z exactly */
   uint64_t primitive_hits; /* Hits where gcd(A,B,C) = 1 (COUNTEREXAMPLES!) */
 
@@ -82,6 +379,29 @@ typedef struct {
   size_t hits_count;
 } SearchResults;
 
+/**
+ * Result of sieve_profile_order(): the moduli in their new test order with
+ * the conditional kill rate of each (fraction of the sampled coprime pairs
+ * still alive at that point that the modulus kills).
+ */
+typedef struct {
+  uint64_t sampled_pairs; /* Coprime pairs sampled */
+  int count;              /* Entries below (byte tier, then wide tier) */
+  uint32_t moduli[MAX_MODULI_LIST];
+  double kill_rate[MAX_MODULI_LIST];
+} SieveProfile;
+
+/**
+ * Sieve kernel used for the hot loop.
+ */
+typedef enum {
+  SIEVE_MODE_LANES = 0, /* Per-pair test (AVX2 32-lane kernel if available) */
+  SIEVE_MODE_ROWS,      /* Row bitmaps ANDed from periodic B patterns */
+  SIEVE_MODE_TIERED,    /* Bitmap prefilter, then compacted survivors */
+  SIEVE_MODE_WHEEL,     /* Only live (A mod W, B mod W) classes, step W */
+  SIEVE_MODE_SLICED     /* Bit-sliced: 64 A rows per word, swept along B */
+} SieveMode;
+
 /**
  * Search parameters.
  */
@@ -93,10 +413,205 @@ typedef struct {
 
   int num_threads;       /* 0 = auto-detect */
   int progress_interval; /* Print progress every N pairs (0 = disabled) */
+  SieveMode sieve_mode;  /* Hot-loop kernel */
+  bool fused;            /* Test CRT-fused prime groups first */
+
+  int num_moduli; /* 0 = SIEVE_PRIMES */
+  uint32_t moduli[MAX_MODULI_LIST];
+  int adaptive_moduli; /* > 0: pick this many primes for the signature */
+  uint64_t reorder_rows; /* > 0: re-profile the test order every N A rows */
+  int deep_primes;       /* Deep bank size (0 = off) */
+  int euler_primes;      /* Euler-filter primes (0 = off) */
+  const char *cache_dir; /* Precompute cache directory (NULL = off) */
+
+  /* z-family run (num_z > 1): z_family[k] replaces z, each signature with
+   * its own log file. z must equal z_family[0]. */
+  int num_z;
+  uint32_t z_family[MAX_Z_FAMILY];
+  const char *family_logs[MAX_Z_FAMILY];
 
   const char *log_path; /* Path to JSONL log file */
 } SearchParams;
 
+/* ============================================================================
+ * MODULAR ARITHMETIC (modarith.c)
+ * Barrett reduction for the table moduli (operands below 2^16, so the
+ * batched kernels stay in 32-bit lanes) and Montgomery arithmetic for
+ * moduli up to 2^63. The table fills go through KernelSet::pow_table8 and
+ * pow_table16, which batch these primitives per instruction set.
+ * ============================================================================
+ */
+
+/* 128-bit products for the 64-bit arithmetic (GCC/Clang) */
+__extension__ typedef unsigned __int128 uint128_t;
+
+/**
+ * Barrett constant for a modulus 2 <= m <= 65536.
+ */
+typedef struct {
+  uint32_t m;
+  uint32_t mu; /* floor(2^32 / m) */
+} Barrett16;
+
+static inline Barrett16 barrett16_init(uint32_t m) {
+  Barrett16 br = {m, (uint32_t)((1ULL << 32) / m)};
+  return br;
+}
+
+/**
+ * t mod m for t < 2^32. The quotient estimate is at most one short, so a
+ * single conditional subtraction finishes the reduction.
+ */
+static inline uint32_t barrett16_reduce(uint32_t t, Barrett16 br) {
+  uint32_t q = (uint32_t)(((uint64_t)t * br.mu) >> 32);
+  uint32_t r = t - q * br.m;
+  return r >= br.m ? r - br.m : r;
+}
+
+/* (a * b) mod m for a, b < m */
+static inline uint32_t barrett16_mul(uint32_t a, uint32_t b, Barrett16 br) {
+  return barrett16_reduce(a * b, br);
+}
+
+static inline Barrett64 barrett64_init(uint32_t m) {
+  Barrett64 br = {m, UINT64_MAX / m};
+  return br;
+}
+
+/**
+ * v mod m for any 64-bit v: a multiply-high instead of a division. The
+ * quotient estimate is at most one short.
+ */
+static inline uint32_t barrett64_reduce(uint64_t v, Barrett64 br) {
+  uint64_t q = (uint64_t)(((uint128_t)v * br.mu) >> 64);
+  uint64_t r = v - q * br.m;
+  return (uint32_t)(r >= br.m ? r - br.m : r);
+}
+
+/**
+ * (a * b) mod n for any 64-bit n > 0.
+ */
+static inline uint64_t mulmod64(uint64_t a, uint64_t b, uint64_t n) {
+  return (uint64_t)((uint128_t)a * b % n);
+}
+
+/**
+ * a^e mod n for any 64-bit n > 0 and exponent.
+ */
+static inline uint64_t powmod64(uint64_t a, uint64_t e, uint64_t n) {
+  uint64_t r = 1 % n;
+  a %= n;
+  while (e) {
+    if (e & 1)
+      r = mulmod64(r, a, n);
+    a = mulmod64(a, a, n);
+    e >>= 1;
+  }
+  return r;
+}
+
+/**
+ * Montgomery reduction: T * R^-1 mod q for T < q * R.
+ */
+static inline uint64_t mont64_redc(uint128_t T, const Montgomery64 *mt) {
+  uint64_t m = (uint64_t)T * mt->q_neg_inv;
+  uint64_t t = (uint64_t)((T + (uint128_t)m * mt->q) >> 64);
+  return t >= mt->q ? t - mt->q : t;
+}
+
+static inline uint64_t mont64_mul(uint64_t a, uint64_t b,
+                                  const Montgomery64 *mt) {
+  return mont64_redc((uint128_t)a * b, mt);
+}
+
+/* a (any 64-bit value) into Montgomery form */
+static inline uint64_t mont64_to(uint64_t a, const Montgomery64 *mt) {
+  return mont64_mul(a % mt->q, mt->r2, mt);
+}
+
+/**
+ * a^e in Montgomery form (a already in Montgomery form).
+ */
+static inline uint64_t mont64_pow(uint64_t a, uint64_t e,
+                                  const Montgomery64 *mt) {
+  uint64_t r = mt->one;
+  while (e) {
+    if (e & 1)
+      r = mont64_mul(r, a, mt);
+    a = mont64_mul(a, a, mt);
+    e >>= 1;
+  }
+  return r;
+}
+
+/**
+ * Montgomery constants for q. Returns false unless q is odd and < 2^63.
+ */
+bool mont64_init(Montgomery64 *mt, uint64_t q);
+
+/**
+ * Deterministic Miller-Rabin for 64-bit n.
+ */
+bool is_prime64(uint64_t n);
+
+/* ============================================================================
+ * PRECOMPUTE CACHE (cache.c)
+ * Derived tables that are slow to build (the wheel) or large (deep banks)
+ * can be kept in files under a cache directory and mapped read-only, so
+ * repeated runs and concurrent processes on one host share a single
+ * page-cache copy. A file carries a versioned header, the key of the
+ * inputs it was built from and a checksum of its payload; a mismatch in
+ * any of them means a rebuild.
+ * ============================================================================
+ */
+
+#define CACHE_VERSION 1
+
+/* FNV-1a offset basis: the initial value for cache_hash() */
+#define CACHE_HASH_INIT 14695981039346656037ULL
+
+typedef enum { CACHE_KIND_WHEEL = 1, CACHE_KIND_DEEP = 2 } CacheKind;
+
+/**
+ * One contiguous piece of a cache payload. Each part starts 8-byte aligned
+ * in the file (cache_align() gives the padded size).
+ */
+typedef struct {
+  const void *data;
+  size_t bytes;
+} CachePart;
+
+static inline size_t cache_align(size_t bytes) {
+  return (bytes + 7) & ~(size_t)7;
+}
+
+/**
+ * FNV-1a over bytes, continuing from h.
+ */
+uint64_t cache_hash(uint64_t h, const void *bytes, size_t n);
+
+/**
+ * Map the cache file for (kind, key) under dir. Returns the payload and
+ * sets *payload_bytes, or NULL if the file is missing, from another
+ * version or key, or fails its checksum.
+ */
+const void *cache_map(const char *dir, CacheKind kind, uint64_t key,
+                      CacheMap *map, uint64_t *payload_bytes);
+
+/**
+ * Write the cache file for (kind, key) under dir from parts, creating dir
+ * if it does not exist. The file is written under a temporary name and
+ * renamed, so readers never see a partial file. Returns false (after a
+ * warning) on I/O errors.
+ */
+bool cache_store(const char *dir, CacheKind kind, uint64_t key,
+                 const CachePart *parts, int count);
+
+/**
+ * Unmap (no-op for an empty map).
+ */
+void cache_unmap(CacheMap *map);
+
 /* ============================================================================
  * PRECOMPUTE FUNCTIONS (precompute.c)
  * ============================================================================
@@ -109,16 +624,116 @@ typedef struct {
 PrecomputedData *precompute_create(uint32_t x, uint32_t y, uint32_t z,
                                    uint64_t A_max, uint64_t B_max);
 
+/**
+ * As precompute_create(), with an explicit list of sieve moduli
+ * (each in [2, MAX_WIDE_MODULUS]). num_moduli <= 0 selects SIEVE_PRIMES.
+ * Moduli up to MAX_SIEVE_MODULUS form the byte tier; larger ones the wide
+ * tier. Returns NULL if either tier overflows.
+ */
+PrecomputedData *precompute_create_moduli(uint32_t x, uint32_t y, uint32_t z,
+                                          uint64_t A_max, uint64_t B_max,
+                                          const uint32_t *moduli,
+                                          int num_moduli);
+
+/**
+ * As precompute_create_moduli(), for the window [A_start, A_max] x
+ * [B_start, B_max] rather than one starting at 1. Tables are indexed by
+ * residue, so a worker given a slice of a large range pays only for its
+ * moduli, never for the bases below its slice. Returns NULL for an empty
+ * window.
+ */
+PrecomputedData *precompute_create_window(uint32_t x, uint32_t y, uint32_t z,
+                                          uint64_t A_start, uint64_t A_max,
+                                          uint64_t B_start, uint64_t B_max,
+                                          const uint32_t *moduli,
+                                          int num_moduli);
+
+/**
+ * Parse a moduli specification: "primes" (the sacred 20), "powers" (the same
+ * with 2, 3, 5, 7, 11 replaced by 128, 81, 125, 49, 121) or a comma-separated
+ * list such as "16,9,25,7,11,113". Values may go up to MAX_WIDE_MODULUS.
+ * Returns false if the list is invalid.
+ */
+bool sieve_moduli_parse(const char *spec, uint32_t *moduli, int *count);
+
+/**
+ * Signature-adaptive moduli: rank the primes below 2^16 by the density of
+ * z-th power residues, about 1/gcd(z, p-1), and write the k sparsest (ties to
+ * the smaller prime) in ascending order.
+ * Returns the number written (k is clamped to MAX_MODULI_LIST).
+ */
+int sieve_moduli_adaptive(uint32_t z, int k, uint32_t *moduli);
+
+/**
+ * Build the CRT-fused pair tables ({2,3,5,7}, {11,13}, {17,19}) so the
+ * scalar and row-bitmap kernels test each group with a single lookup.
+ * Returns false on allocation failure (data is left without fused groups).
+ */
+bool precompute_build_fused(PrecomputedData *data);
+
+/**
+ * Build the prefix-pattern cache used by the row-bitmap and tiered sieves:
+ * walk data->order and take each non-fused byte-tier modulus coprime to the
+ * product so far while the period stays <= MAX_PREFIX_PERIOD and the
+ * patterns fit MAX_PREFIX_CACHE_BYTES. Left empty with fewer than two
+ * members, or when a sweep of rows x cols pairs would not repay the build
+ * PREFIX_MIN_GAIN times over. Call after precompute_build_fused() and
+ * sieve_profile_order(). Returns false on allocation failure.
+ */
+bool precompute_build_prefix(PrecomputedData *data, uint64_t rows,
+                             uint64_t cols);
+
+/**
+ * Build the residue-class wheel: walk data->order and take each byte-tier
+ * modulus coprime to the product so far while it stays <= MAX_WHEEL_MODULUS
+ * (so call after sieve_profile_order() to favour the strongest moduli).
+ * With data->cache_dir set the class tables are mapped from the cache, or
+ * built and stored there. Returns false on allocation failure (data is left
+ * without a wheel).
+ */
+bool precompute_build_wheel(PrecomputedData *data);
+
+/**
+ * Build the smallest-prime-factor table for A in [A_start, min(A_max,
+ * FACTOR_TABLE_LIMIT)], by a segmented sieve over primes <= sqrt of the
+ * top, so a window costs the same wherever it sits. Returns false on
+ * allocation failure.
+ */
+bool precompute_build_factors(PrecomputedData *data);
+
+/**
+ * Build the deep bank: the count best primes for data->z (ranked as in
+ * sieve_moduli_adaptive()) that divide none of the sieve moduli.
+ * count is clamped to MAX_DEEP_PRIMES. Uses data->cache_dir as the wheel
+ * does. Returns false on allocation failure.
+ */
+bool precompute_build_deep(PrecomputedData *data, int count);
+
+/**
+ * Build the z-family tables for the count exponents z[] (data's own z need
+ * not be among them; x, y and the moduli are shared), with a deep bank of
+ * deep_count primes per exponent. Returns false on a bad count or
+ * allocation failure.
+ */
+bool precompute_build_family(PrecomputedData *data, const uint32_t *z,
+                             int count, int deep_count);
+
+/**
+ * Bytes held by every built or mapped table: the core, factor, fused,
+ * prefix, wheel, deep-bank and z-family tables.
+ */
+size_t precompute_table_bytes(const PrecomputedData *data);
+
 /**
  * Free precomputed data.
  */
 void precompute_free(PrecomputedData *data);
 
 /**
- * Compute z-th power residue set for a prime p.
+ * Compute z-th power residue set modulo m (prime or prime power, m <= 128).
  * Fills a 128-bit mask (2x64).
  */
-void compute_residue_mask128(uint32_t p, uint32_t z, uint64_t mask[2]);
+void compute_residue_mask128(uint32_t m, uint32_t z, uint64_t mask[2]);
 
 /* ============================================================================
  * SIEVE FUNCTIONS (sieve.c)
@@ -126,7 +741,29 @@ void compute_residue_mask128(uint32_t p, uint32_t z, uint64_t mask[2]);
  */
 
 /**
- * Check if a pair (A, B) survives the 20-prime sieve.
+ * A^x mod moduli[i] from the residue-indexed table.
+ */
+static inline uint32_t sieve_ax(const PrecomputedData *data, int i,
+                                uint64_t A) {
+  return data->ax_pow[i][barrett64_reduce(A, data->reduce[i])];
+}
+
+/**
+ * B^y mod moduli[i]; by_pow[i] + sieve_b_offset() starts a run of
+ * SIEVE_LANE_PAD consecutive B.
+ */
+static inline uint32_t sieve_b_offset(const PrecomputedData *data, int i,
+                                      uint64_t B) {
+  return barrett64_reduce(B, data->reduce[i]);
+}
+
+static inline uint32_t sieve_by(const PrecomputedData *data, int i,
+                                uint64_t B) {
+  return data->by_pow[i][sieve_b_offset(data, i, B)];
+}
+
+/**
+ * Check if a pair (A, B) survives the modular sieve (20 primes by default).
  * Returns true if the pair survives (needs exact GMP verification).
  * Returns false if the pair is killed (impossibility proven by residues).
  *
@@ -134,6 +771,98 @@ void compute_residue_mask128(uint32_t p, uint32_t z, uint64_t mask[2]);
  */
 bool sieve_survives_scalar(uint64_t A, uint64_t B, const PrecomputedData *data);
 
+/**
+ * Row-bitmap sieve: fill out[0..nwords) with survivor bits for
+ * B_start + 64*j + k (bit k of word j), for a fixed A.
+ * Each word is the AND of one 64-bit window per prime taken from the
+ * periodic pattern selected by A^x mod moduli[i]. Bits past B_max are NOT
+ * masked; the caller must ignore them.
+ */
+void sieve_row_bitmap(uint64_t A, uint64_t B_start, size_t nwords,
+                      uint64_t *out, const PrecomputedData *data);
+
+/**
+ * Bit-sliced sieve for a tile of 64 A rows: fill out[0..count) so that bit k
+ * of out[j] is set iff (A_start + k, B_start + j) survives every byte-tier
+ * and wide-tier modulus. Bits for A > A_max are cleared; count must not
+ * exceed SIEVE_ROW_BLOCK. Fused groups are not used (every modulus is
+ * tested directly).
+ */
+void sieve_sliced_tile(uint64_t A_start, uint64_t B_start, size_t count,
+                       uint64_t *out, const PrecomputedData *data);
+
+/**
+ * Tier 1 of the tiered sieve: as sieve_row_bitmap(), but only the fused
+ * groups, the prefix cache (counting as its members) and the first n_prefix
+ * other moduli of data->order are applied. Bits past B_max are NOT masked.
+ */
+void sieve_row_prefix(uint64_t A, uint64_t B_start, size_t nwords,
+                      uint64_t *out, const PrecomputedData *data,
+                      int n_prefix);
+
+/**
+ * Write the indices of the set bits of bits[0..nwords) to idx in ascending
+ * order. Returns the number written (at most 64 * nwords).
+ */
+size_t sieve_compact_bits(const uint64_t *bits, size_t nwords, uint32_t *idx);
+
+/**
+ * Tier 2 of the tiered sieve: filter the offsets idx[0..n) (B = B_start +
+ * idx[k], all <= B_max) through the moduli sieve_row_prefix() skipped and the
+ * wide tier, compacting survivors in place. Returns the survivor count.
+ * A negative n_prefix means nothing was prefiltered: the fused groups and
+ * every modulus are applied.
+ */
+size_t sieve_filter_compact(uint64_t A, uint64_t B_start, uint32_t *idx,
+                            size_t n, const PrecomputedData *data,
+                            int n_prefix);
+
+/**
+ * Measure each modulus's conditional kill rate on coprime pairs sampled from
+ * [A_lo, A_hi] x [B_lo, B_hi] (up to 2048 rows x 128 columns) and reorder
+ * data->order / data->wide_order greedily so that the modulus killing the
+ * most still-alive pairs is tested next. Fused groups stay first.
+ * Does not change which pairs survive, only how soon they die.
+ */
+void sieve_profile_order(PrecomputedData *data, uint64_t A_lo, uint64_t A_hi,
+                         uint64_t B_lo, uint64_t B_hi, SieveProfile *out);
+
+/**
+ * Deep-bank check for a sieve survivor (true if the bank is empty).
+ */
+bool sieve_deep_survives(uint64_t A, uint64_t B, const DeepBank *bank);
+
+/**
+ * z-family sieve for one pair (data->family must be built; fused groups are
+ * not applied). Returns a mask with bit k set iff (A, B) survives every
+ * modulus for z = family.z[k].
+ */
+uint32_t sieve_family_scalar(uint64_t A, uint64_t B,
+                             const PrecomputedData *data);
+
+/**
+ * Wide-tier check alone (true if there are no wide moduli).
+ */
+bool sieve_wide_survives(uint64_t A, uint64_t B, const PrecomputedData *data);
+
+/**
+ * Wide tier for a z-family: clears the bits of alive (as returned by
+ * sieve_family_scalar()) whose signature some wide modulus kills.
+ */
+uint32_t sieve_family_wide(uint64_t A, uint64_t B, const PrecomputedData *data,
+                           uint32_t alive);
+
+/**
+ * Parse a sieve mode name ("lanes", "rows", "tiered", "wheel", "sliced").
+ * Returns false if unknown.
+ */
+bool sieve_mode_parse(const char *name, SieveMode *out);
+
+/**
+ * Name of a sieve mode, as written to logs.
+ */
+const char *sieve_mode_name(SieveMode mode);
+
 /**
  * Count survivors in a range (for validation).
  */
@@ -141,14 +870,82 @@ uint64_t count_sieve_survivors(uint64_t A_start, uint64_t A_end,
                                uint64_t B_start, uint64_t B_end,
                                const PrecomputedData *data);
 
-#ifdef HAVE_AVX2
+/* ============================================================================
+ * MULTIVERSIONED KERNELS (kernels.c per instruction set, dispatch.c)
+ * ============================================================================
+ */
+
+/**
+ * Instruction sets the kernels are compiled for, in increasing order.
+ */
+typedef enum {
+  KERNEL_ISA_BASELINE = 0, /* Plain C for the target's base ISA */
+  KERNEL_ISA_SSE41,        /* SSE4.1 (16-byte shuffles), POPCNT */
+  KERNEL_ISA_AVX2,         /* AVX2, BMI1/2 */
+  KERNEL_ISA_AVX512        /* AVX-512 F/BW/VL, BMI1/2 */
+} KernelIsa;
+
+/**
+ * One instruction-set variant of the hot kernels.
+ */
+typedef struct {
+  const char *name; /* "baseline", "sse4.1", "avx2" or "avx512" */
+  KernelIsa isa;
+
+  /* Sieve check for 32 B values at once (one byte lane per B): bit i is set
+   * iff B_start + i survives. Lanes past B_max are reported as killed. */
+  uint32_t (*survives_32)(uint64_t A, uint64_t B_start,
+                          const PrecomputedData *data);
+
+  /* z-family check for 32 B values: survivors[k] receives the lane mask for
+   * z = family.z[k], as survives_32 would for that signature. */
+  void (*family_32)(uint64_t A, uint64_t B_start,
+                    const PrecomputedData *data, uint32_t *survivors);
+
+  uint64_t (*gcd)(uint64_t a, uint64_t b); /* Same result as gcd64() */
+
+  /* out[v] = v^e mod m for v < count, batched Barrett (2 <= m <= 256) */
+  void (*pow_table8)(uint8_t *out, uint64_t count, uint32_t e, uint32_t m);
+
+  /* As pow_table8 for 2 <= m <= 65536 */
+  void (*pow_table16)(uint16_t *out, uint64_t count, uint32_t e, uint32_t m);
+} KernelSet;
+
+/**
+ * Select the kernel variant by name ("baseline", "sse4.1", "avx2",
+ * "avx512"), or the best one this CPU supports for "auto" or NULL.
+ * Support is detected with cpuid. Returns false (keeping the current
+ * selection) if the variant was not compiled in or the CPU lacks it.
+ */
+bool kernel_select(const char *name);
+
+/**
+ * The selected kernel variant (auto-selected on first use).
+ */
+const KernelSet *kernel_active(void);
+
+/**
+ * Write the compiled-in variants this CPU supports, best first, to out
+ * (room for KERNEL_ISA_AVX512 + 1 entries) and return how many.
+ */
+int kernel_available(const KernelSet **out);
+
+/* ============================================================================
+ * SPECIALIZED KERNELS (generated at build time by tools/gen_kernels.c)
+ * ============================================================================
+ */
+
 /**
- * AVX2-optimized sieve check for 8 B values at once.
- * Returns a bitmask where bit i is set iff B_start+i survives.
+ * Per-pair sieve test with the signature and the sacred 20 primes compiled
+ * in. Same verdict as sieve_survives_scalar() with the default moduli.
  */
-uint8_t sieve_survives_avx2_8(uint64_t A, uint64_t B_start,
-                              const PrecomputedData *data);
-#endif
+typedef bool (*SieveKernelFn)(uint64_t A, uint64_t B);
+
+/**
+ * Specialized kernel for signature (x, y, z), or NULL if none was generated
+ * (see HG_SPECIALIZED_SIGNATURES in CMakeLists.txt).
+ */
+SieveKernelFn sieve_kernel_lookup(uint32_t x, uint32_t y, uint32_t z);
 
 /* ============================================================================
  * GMP VERIFICATION (gmp_verify.c)
@@ -166,12 +963,94 @@ bool check_beal_hit_gmp(uint64_t A, uint64_t B, uint32_t x, uint32_t y,
                         uint32_t z, uint64_t C_max, uint64_t *out_C,
                         uint64_t *out_gcd);
 
+/**
+ * As check_beal_hit_gmp() in fixed-width arithmetic: unsigned __int128 when
+ * A^x + B^y fits, 256-bit limbs otherwise, with the z-th root from a
+ * floating-point estimate corrected by exact exponentiation. Sets *decided
+ * to false (and returns false) when the sum overflows 256 bits; only then
+ * is GMP needed.
+ */
+bool check_beal_hit_fixed(uint64_t A, uint64_t B, uint32_t x, uint32_t y,
+                          uint32_t z, uint64_t C_max, uint64_t *out_C,
+                          uint64_t *out_gcd, bool *decided);
+
+/**
+ * Reusable verification state for one signature, owned by one thread: GMP
+ * integers preallocated for the largest sum, and A^x cached across a row.
+ * Opaque so that this header does not need gmp.h.
+ */
+typedef struct GmpVerifier GmpVerifier;
+
+/**
+ * Create a verifier for (x, y, z) sized for A <= A_max and B <= B_max
+ * (larger bases still work, at the cost of a reallocation). Returns NULL on
+ * allocation failure.
+ */
+GmpVerifier *gmp_verifier_create(uint32_t x, uint32_t y, uint32_t z,
+                                 uint64_t A_max, uint64_t B_max);
+
+/**
+ * As check_beal_hit_gmp() for the verifier's signature, by
+ * check_beal_hit_fixed() unless the sum overflows its fixed width. A^x is
+ * recomputed in GMP only when A differs from the previous call's. Built
+ * with HG_VERIFY_CROSSCHECK, every fixed-width verdict is compared with
+ * GMP's and a mismatch aborts.
+ */
+bool gmp_verifier_check(GmpVerifier *ver, uint64_t A, uint64_t B,
+                        uint64_t C_max, uint64_t *out_C, uint64_t *out_gcd);
+
+/**
+ * Free a verifier (NULL is ignored).
+ */
+void gmp_verifier_free(GmpVerifier *ver);
+
+/**
+ * Pick count (<= MAX_EULER_PRIMES) primes q = 1 (mod z) just below 2^61 and
+ * their Montgomery constants. Returns false if count is out of range.
+ */
+bool euler_filter_init(EulerFilter *filter, uint32_t z, int count);
+
+/**
+ * Euler's criterion on A^x + B^y: false iff the sum is provably not a z-th
+ * power, i.e. for some filter prime q it is nonzero mod q with
+ * (A^x + B^y)^((q-1)/z) != 1 (mod q). True for an empty filter.
+ */
+bool euler_filter_passes(const EulerFilter *filter, uint64_t A, uint64_t B,
+                         uint32_t x, uint32_t y);
+
 /**
  * Binary GCD for 64-bit integers.
  * Identical to Python's math.gcd behavior.
  */
 uint64_t gcd64(uint64_t a, uint64_t b);
 
+/**
+ * Number of B in [lo, hi] with gcd(A, B) == 1 (lo >= 1), by inclusion-
+ * exclusion over the distinct prime factors of A.
+ */
+uint64_t count_coprime_range(uint64_t A, uint64_t lo, uint64_t hi);
+
+/**
+ * Write the distinct prime factors of A >= 1 to primes (ascending, at most
+ * MAX_DISTINCT_PRIMES) and return their count. Uses table when it covers A
+ * (table may be NULL), trial division otherwise.
+ */
+int factor_distinct(uint64_t A, const FactorTable *table, uint64_t *primes);
+
+/**
+ * As count_coprime_range(), given the distinct primes of A.
+ */
+uint64_t count_coprime_primes(const uint64_t *primes, int np, uint64_t lo,
+                              uint64_t hi);
+
+/**
+ * Coprimality bitmap of a B block: bit k of bits[0..nwords) is set iff
+ * B0 + k shares none of primes (the distinct primes of some A), i.e. iff
+ * gcd(A, B0 + k) == 1. Built by striding over the multiples of each prime.
+ */
+void coprime_bitmap(const uint64_t *primes, int np, uint64_t B0,
+                    size_t nwords, uint64_t *bits);
+
 /* ============================================================================
  * PARALLEL SEARCH (parallel.c)
  * ============================================================================
@@ -179,7 +1058,8 @@ uint64_t gcd64(uint64_t a, uint64_t b);
 
 /**
  * Main search function with OpenMP parallelization.
- * This is the entry point for the exhaustive search.
+ * This is the entry point for the exhaustive search. For a z-family run
+ * results must hold params->num_z entries, one per signature.
  */
 void search_parallel(const SearchParams *params, SearchResults *results);
 
@@ -207,13 +1087,17 @@ void results_add_hit(SearchResults *results, const BealHit *hit);
  * JSONL logging functions matching Python engine format.
  */
 
-void log_start(const char *path, const SearchParams *params, int num_workers);
+void log_start(const char *path, const SearchParams *params,
+               const PrecomputedData *data, int num_workers,
+               double precompute_seconds);
 void log_checkpoint(const char *path, uint64_t run_id, uint64_t pairs_completed,
                     uint64_t pairs_expected, uint64_t gcd_skips,
                     uint64_t mod_skips, double elapsed_seconds, int chunks_done,
                     int chunks_total);
 void log_complete(const char *path, uint64_t run_id, const SearchParams *params,
                   const SearchResults *results);
+void log_sieve_order(const char *path, uint64_t run_id, uint64_t A_from,
+                     const SieveProfile *profile);
 void log_hit(const char *path, const BealHit *hit);
 
 /**
@@ -228,9 +1112,13 @@ void get_timestamp_iso(char *buf, size_t len);
 
 /**
  * Modular exponentiation: compute base^exp mod m.
- * Uses binary exponentiation for efficiency.
+ * Uses binary exponentiation for efficiency. The products fit 64 bits for
+ * m <= 2^32; larger moduli take the 128-bit path.
  */
 static inline uint64_t powmod(uint64_t base, uint32_t exp, uint64_t m) {
+  if (m > (1ULL << 32))
+    return powmod64(base, exp, m);
+
   uint64_t result = 1;
   base %= m;
   while (exp > 0) {
@@ -262,4 +1150,14 @@ static inline void set_bit128(uint64_t mask[2], uint32_t bit) {
     mask[1] |= (1ULL << (bit - 64));
 }
 
+/**
+ * Extract the 64-bit window of a periodic pattern starting at bit r.
+ * The second shift is split so that r % 64 == 0 does not shift by 64.
+ */
+static inline uint64_t pattern_window(const uint64_t *pat, uint32_t r) {
+  uint32_t w = r >> 6;
+  uint32_t s = r & 63;
+  return (pat[w] >> s) | ((pat[w + 1] << 1) << (63 - s));
+}
+
 #endif /* HYPER_GOLIATH_H */
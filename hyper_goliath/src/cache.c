@@ -0,0 +1,149 @@
+/**
+ * On-disk precompute cache.
+ *
+ * A cache file is a CacheHeader followed by the payload parts, each padded
+ * to 8 bytes. Files are named by kind and key, written under a temporary
+ * name and renamed into place: concurrent writers of one key race
+ * harmlessly and readers only ever map complete files.
+ */
+
+#include "hyper_goliath.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC "HGCACHE"
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t kind;
+  uint64_t key;
+  uint64_t payload_bytes;
+  uint64_t checksum; /* cache_hash() of the payload */
+  uint8_t reserved[24];
+} CacheHeader;
+
+/**
+ * FNV-1a over bytes.
+ */
+uint64_t cache_hash(uint64_t h, const void *bytes, size_t n) {
+  const uint8_t *p = (const uint8_t *)bytes;
+  for (size_t i = 0; i < n; i++) {
+    h ^= p[i];
+    h *= 1099511628211ULL; /* FNV prime */
+  }
+  return h;
+}
+
+static void cache_path(char *out, size_t len, const char *dir, CacheKind kind,
+                       uint64_t key) {
+  snprintf(out, len, "%s/%s-%016llx.hgc", dir,
+           kind == CACHE_KIND_WHEEL ? "wheel" : "deep",
+           (unsigned long long)key);
+}
+
+/**
+ * Map and validate a cache file.
+ */
+const void *cache_map(const char *dir, CacheKind kind, uint64_t key,
+                      CacheMap *map, uint64_t *payload_bytes) {
+  char path[4096];
+  cache_path(path, sizeof(path), dir, kind, key);
+  memset(map, 0, sizeof(*map));
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CacheHeader)) {
+    close(fd);
+    return NULL;
+  }
+  void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return NULL;
+
+  const CacheHeader *hdr = (const CacheHeader *)base;
+  const uint8_t *payload = (const uint8_t *)base + sizeof(CacheHeader);
+  if (memcmp(hdr->magic, CACHE_MAGIC, sizeof(hdr->magic)) != 0 ||
+      hdr->version != CACHE_VERSION || hdr->kind != (uint32_t)kind ||
+      hdr->key != key ||
+      hdr->payload_bytes != (uint64_t)st.st_size - sizeof(CacheHeader) ||
+      cache_hash(CACHE_HASH_INIT, payload, hdr->payload_bytes) !=
+          hdr->checksum) {
+    fprintf(stderr, "WARNING: Ignoring stale or corrupt cache file %s\n",
+            path);
+    munmap(base, (size_t)st.st_size);
+    return NULL;
+  }
+
+  map->base = base;
+  map->size = (size_t)st.st_size;
+  *payload_bytes = hdr->payload_bytes;
+  return payload;
+}
+
+/**
+ * Write a cache file.
+ */
+bool cache_store(const char *dir, CacheKind kind, uint64_t key,
+                 const CachePart *parts, int count) {
+  static const uint8_t zeros[8] = {0};
+  char path[4096], tmp[4096 + 32];
+  cache_path(path, sizeof(path), dir, kind, key);
+  snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+
+  CacheHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic));
+  hdr.version = CACHE_VERSION;
+  hdr.kind = (uint32_t)kind;
+  hdr.key = key;
+  hdr.checksum = CACHE_HASH_INIT;
+  for (int i = 0; i < count; i++) {
+    size_t pad = cache_align(parts[i].bytes) - parts[i].bytes;
+    hdr.checksum = cache_hash(hdr.checksum, parts[i].data, parts[i].bytes);
+    hdr.checksum = cache_hash(hdr.checksum, zeros, pad);
+    hdr.payload_bytes += parts[i].bytes + pad;
+  }
+
+  /* Create the directory (not its parents) on first use */
+  if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "WARNING: Cannot create cache directory %s\n", dir);
+    return false;
+  }
+
+  FILE *f = fopen(tmp, "wb");
+  if (!f) {
+    fprintf(stderr, "WARNING: Cannot write cache file %s\n", tmp);
+    return false;
+  }
+  bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+  for (int i = 0; i < count && ok; i++) {
+    size_t pad = cache_align(parts[i].bytes) - parts[i].bytes;
+    ok = fwrite(parts[i].data, 1, parts[i].bytes, f) == parts[i].bytes &&
+         fwrite(zeros, 1, pad, f) == pad;
+  }
+  ok = fclose(f) == 0 && ok;
+  if (!ok || rename(tmp, path) != 0) {
+    fprintf(stderr, "WARNING: Failed to write cache file %s\n", path);
+    unlink(tmp);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Unmap a cache file.
+ */
+void cache_unmap(CacheMap *map) {
+  if (map->base)
+    munmap(map->base, map->size);
+  memset(map, 0, sizeof(*map));
+}
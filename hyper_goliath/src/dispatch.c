@@ -0,0 +1,114 @@
+/**
+ * Runtime selection among the compiled kernel variants (see kernels.c).
+ */
+
+#include "hyper_goliath.h"
+#include <stdio.h>
+#include <string.h>
+
+extern const KernelSet kernel_set_baseline;
+#ifdef HAVE_KERNEL_SSE41
+extern const KernelSet kernel_set_sse41;
+#endif
+#ifdef HAVE_KERNEL_AVX2
+extern const KernelSet kernel_set_avx2;
+#endif
+#ifdef HAVE_KERNEL_AVX512
+extern const KernelSet kernel_set_avx512;
+#endif
+
+/* Compiled-in variants, best first */
+static const KernelSet *const KERNEL_SETS[] = {
+#ifdef HAVE_KERNEL_AVX512
+    &kernel_set_avx512,
+#endif
+#ifdef HAVE_KERNEL_AVX2
+    &kernel_set_avx2,
+#endif
+#ifdef HAVE_KERNEL_SSE41
+    &kernel_set_sse41,
+#endif
+    &kernel_set_baseline,
+};
+
+#define NUM_KERNEL_SETS (int)(sizeof(KERNEL_SETS) / sizeof(KERNEL_SETS[0]))
+
+static const KernelSet *active_kernels = NULL;
+
+/**
+ * Does this CPU (and OS, for the wider register state) support isa?
+ * __builtin_cpu_supports() reads the cpuid feature bits once at startup.
+ */
+static bool cpu_supports(KernelIsa isa) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  switch (isa) {
+  case KERNEL_ISA_AVX512:
+    return __builtin_cpu_supports("avx512f") &&
+           __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512vl") &&
+           __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+  case KERNEL_ISA_AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+           __builtin_cpu_supports("bmi2");
+  case KERNEL_ISA_SSE41:
+    return __builtin_cpu_supports("sse4.1") &&
+           __builtin_cpu_supports("popcnt");
+  case KERNEL_ISA_BASELINE:
+    return true;
+  }
+  return false;
+#else
+  return isa == KERNEL_ISA_BASELINE;
+#endif
+}
+
+/**
+ * List the usable variants, best first.
+ */
+int kernel_available(const KernelSet **out) {
+  int n = 0;
+  for (int i = 0; i < NUM_KERNEL_SETS; i++) {
+    if (cpu_supports(KERNEL_SETS[i]->isa))
+      out[n++] = KERNEL_SETS[i];
+  }
+  return n;
+}
+
+/**
+ * Select a variant by name, or the best usable one.
+ */
+bool kernel_select(const char *name) {
+  const KernelSet *usable[NUM_KERNEL_SETS];
+  int n = kernel_available(usable);
+
+  if (!name || strcmp(name, "auto") == 0) {
+    active_kernels = usable[0];
+    return true;
+  }
+
+  for (int i = 0; i < NUM_KERNEL_SETS; i++) {
+    if (strcmp(KERNEL_SETS[i]->name, name) != 0)
+      continue;
+    for (int u = 0; u < n; u++) {
+      if (usable[u] == KERNEL_SETS[i]) {
+        active_kernels = usable[u];
+        return true;
+      }
+    }
+    fprintf(stderr, "ERROR: This CPU does not support the %s kernels\n",
+            name);
+    return false;
+  }
+  fprintf(stderr, "ERROR: Kernel variant '%s' is not compiled in\n", name);
+  return false;
+}
+
+/**
+ * The selected variant.
+ */
+const KernelSet *kernel_active(void) {
+  if (!active_kernels)
+    kernel_select(NULL);
+  return active_kernels;
+}
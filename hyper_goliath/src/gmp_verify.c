@@ -5,11 +5,41 @@
  * whether A^x + B^y = C^z for some integer C.
  *
  * This uses GMP (GNU Multiple Precision Arithmetic Library) to handle
- * arbitrarily large numbers without floating-point errors.
+ * arbitrarily large numbers without floating-point errors. The hot path
+ * (gmp_verifier_check) first tries 128/256-bit integers and only falls
+ * back to GMP when the sum is wider.
  */
 
 #include "hyper_goliath.h"
 #include <gmp.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * If sum is a perfect z-th power C^z with 0 < C <= C_max, set *out_C and
+ * *out_gcd = gcd(A, B, C) and return true. root receives the z-th root.
+ */
+static bool root_hit(mpz_t root, const mpz_t sum, uint32_t z, uint64_t A,
+                     uint64_t B, uint64_t C_max, uint64_t *out_C,
+                     uint64_t *out_gcd) {
+  /* mpz_root returns non-zero iff 'sum' is a perfect z-th power */
+  if (!mpz_root(root, sum, (unsigned long)z))
+    return false;
+
+  /* Check if C fits in uint64_t and is <= C_max */
+  if (!mpz_fits_ulong_p(root))
+    return false;
+  uint64_t C = mpz_get_ui(root);
+  if (C > C_max || C == 0)
+    return false;
+
+  *out_C = C;
+  /* Compute gcd(A, gcd(B, C)) */
+  *out_gcd = gcd64(A, gcd64(B, C));
+  return true;
+}
 
 /**
  * Check if A^x + B^y is a perfect z-th power.
@@ -27,41 +57,263 @@ bool check_beal_hit_gmp(uint64_t A, uint64_t B, uint32_t x, uint32_t y,
   mpz_t ax, by, sum, root;
   mpz_inits(ax, by, sum, root, NULL);
 
-  /* Compute A^x using GMP */
   mpz_ui_pow_ui(ax, (unsigned long)A, (unsigned long)x);
-
-  /* Compute B^y using GMP */
   mpz_ui_pow_ui(by, (unsigned long)B, (unsigned long)y);
-
-  /* sum = A^x + B^y */
   mpz_add(sum, ax, by);
+  bool result = root_hit(root, sum, z, A, B, C_max, out_C, out_gcd);
 
-  /* Check if sum is a perfect z-th power */
-  /* mpz_root returns non-zero iff 'sum' is a perfect z-th power */
-  int is_perfect = mpz_root(root, sum, (unsigned long)z);
+  mpz_clears(ax, by, sum, root, NULL);
+  return result;
+}
+
+/* ============================================================================
+ * FIXED-WIDTH VERIFICATION
+ * ============================================================================
+ */
+
+/**
+ * 256-bit unsigned integer, least significant limb first.
+ */
+typedef struct {
+  uint64_t w[4];
+} U256;
+
+/**
+ * v *= m; false if the product overflows 256 bits.
+ */
+static bool u256_mul64(U256 *v, uint64_t m) {
+  uint128_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    uint128_t t = (uint128_t)v->w[i] * m + carry;
+    v->w[i] = (uint64_t)t;
+    carry = t >> 64;
+  }
+  return carry == 0;
+}
+
+/**
+ * *out = a + b; false if the sum overflows 256 bits.
+ */
+static bool u256_add(const U256 *a, const U256 *b, U256 *out) {
+  uint64_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    uint128_t t = (uint128_t)a->w[i] + b->w[i] + carry;
+    out->w[i] = (uint64_t)t;
+    carry = (uint64_t)(t >> 64);
+  }
+  return carry == 0;
+}
 
-  bool result = false;
+/**
+ * Sign of a - b.
+ */
+static int u256_cmp(const U256 *a, const U256 *b) {
+  for (int i = 3; i >= 0; i--) {
+    if (a->w[i] != b->w[i])
+      return a->w[i] < b->w[i] ? -1 : 1;
+  }
+  return 0;
+}
 
-  if (is_perfect) {
-    /* Verify: We found C such that C^z = A^x + B^y */
-    /* Check if C fits in uint64_t and is <= C_max */
-    if (mpz_fits_ulong_p(root)) {
-      uint64_t C = mpz_get_ui(root);
+/**
+ * *out = a^e, in unsigned __int128 while it fits and 256-bit limbs after;
+ * false if it overflows 256 bits.
+ */
+static bool pow_fixed(uint64_t a, uint32_t e, U256 *out) {
+  uint128_t r = 1;
+  uint32_t i = 0;
+  for (; i < e; i++) {
+    uint64_t hi = (uint64_t)(r >> 64);
+    uint128_t lo = (uint128_t)(uint64_t)r * a;
+    uint128_t top = (uint128_t)hi * a;
+    if ((top >> 64) || (uint64_t)(lo >> 64) + (uint64_t)top < (uint64_t)top)
+      break;
+    r = lo + (top << 64);
+  }
+  *out = (U256){{(uint64_t)r, (uint64_t)(r >> 64), 0, 0}};
+  for (; i < e; i++) {
+    if (!u256_mul64(out, a))
+      return false;
+  }
+  return true;
+}
 
-      if (C <= C_max && C > 0) {
-        *out_C = C;
+/**
+ * Sign of c^z - n (an overflowing c^z is larger than any n).
+ */
+static int cmp_pow(uint64_t c, uint32_t z, const U256 *n) {
+  U256 p;
+  if (!pow_fixed(c, z, &p))
+    return 1;
+  return u256_cmp(&p, n);
+}
 
-        /* Compute gcd(A, gcd(B, C)) */
-        uint64_t g1 = gcd64(B, C);
-        *out_gcd = gcd64(A, g1);
+/**
+ * Is sum a z-th power C^z with 0 < C <= C_max?
+ *
+ * Below 2^36 the double estimate of the root is within 1/64 of the real
+ * root, so the only candidate is the nearest integer, and comparing C^z
+ * with the sum modulo 2^64 rejects nearly every non-hit for the price of z
+ * 64-bit multiplies. Larger roots are bracketed from a long double estimate
+ * and corrected by exact exponentiation.
+ */
+static bool fixed_root(const U256 *sum, uint32_t z, uint64_t C_max,
+                       uint64_t *out_C) {
+  double v = 0;
+  for (int i = 3; i >= 0; i--)
+    v = v * 0x1p64 + (double)sum->w[i];
+  double est = pow(v, 1.0 / z);
+  if (est > (double)C_max * (1.0 + 0x1p-30) + 1.0)
+    return false;
 
-        result = true;
-      }
-    }
+  uint64_t C;
+  if (est < 0x1p36) {
+    C = (uint64_t)(est + 0.5);
+    uint64_t low = 1;
+    for (uint32_t i = 0; i < z; i++)
+      low *= C;
+    if (low != sum->w[0] || cmp_pow(C, z, sum) != 0)
+      return false;
+  } else {
+    long double lv = 0;
+    for (int i = 3; i >= 0; i--)
+      lv = lv * 0x1p64L + (long double)sum->w[i];
+    long double lest = powl(lv, 1.0L / (long double)z);
+    C = lest >= 0x1p64L ? UINT64_MAX : (uint64_t)lest;
+    /* Correct to floor(sum^(1/z)) */
+    while (C > 0 && cmp_pow(C, z, sum) > 0)
+      C--;
+    while (C < UINT64_MAX && cmp_pow(C + 1, z, sum) <= 0)
+      C++;
+    if (cmp_pow(C, z, sum) != 0)
+      return false;
   }
 
-  mpz_clears(ax, by, sum, root, NULL);
-  return result;
+  if (C > C_max || C == 0)
+    return false;
+  *out_C = C;
+  return true;
+}
+
+/**
+ * Fixed-width check of ax + B^y, with ax = A^x already computed.
+ */
+static bool fixed_check(const U256 *ax, uint64_t A, uint64_t B, uint32_t y,
+                        uint32_t z, uint64_t C_max, uint64_t *out_C,
+                        uint64_t *out_gcd, bool *decided) {
+  U256 by, sum;
+  *decided = pow_fixed(B, y, &by) && u256_add(ax, &by, &sum);
+  if (!*decided || !fixed_root(&sum, z, C_max, out_C))
+    return false;
+  *out_gcd = gcd64(A, gcd64(B, *out_C));
+  return true;
+}
+
+/**
+ * Fixed-width check of A^x + B^y.
+ */
+bool check_beal_hit_fixed(uint64_t A, uint64_t B, uint32_t x, uint32_t y,
+                          uint32_t z, uint64_t C_max, uint64_t *out_C,
+                          uint64_t *out_gcd, bool *decided) {
+  U256 ax;
+  if (!pow_fixed(A, x, &ax)) {
+    *decided = false;
+    return false;
+  }
+  return fixed_check(&ax, A, B, y, z, C_max, out_C, out_gcd, decided);
+}
+
+/* ============================================================================
+ * REUSABLE GMP CONTEXT
+ * ============================================================================
+ */
+
+/**
+ * Per-thread verification state. Every integer is grown once to its final
+ * size, so checks make no malloc/free calls: GMP's own temporaries in
+ * mpz_root() come from the stack (TMP_ALLOC) at these sizes.
+ */
+struct GmpVerifier {
+  uint32_t x, y, z;
+  uint64_t A; /* Base of the cached ax (0 = none) */
+  mpz_t ax, by, sum, root;
+  uint64_t A_fixed; /* Base of the cached ax_fixed (0 = none) */
+  bool ax_fits;     /* ax_fixed holds A_fixed^x */
+  U256 ax_fixed;
+};
+
+/**
+ * GMP check of a pair with the verifier's preallocated integers.
+ */
+static bool verifier_gmp(GmpVerifier *ver, uint64_t A, uint64_t B,
+                         uint64_t C_max, uint64_t *out_C, uint64_t *out_gcd) {
+  if (A != ver->A) {
+    mpz_ui_pow_ui(ver->ax, (unsigned long)A, (unsigned long)ver->x);
+    ver->A = A;
+  }
+  mpz_ui_pow_ui(ver->by, (unsigned long)B, (unsigned long)ver->y);
+  mpz_add(ver->sum, ver->ax, ver->by);
+  return root_hit(ver->root, ver->sum, ver->z, A, B, C_max, out_C, out_gcd);
+}
+
+/**
+ * Create a verifier. Rather than guessing GMP's size estimates (which add
+ * slack over the exact bit counts), one check of the largest pair grows
+ * every integer to the size any pair in range needs.
+ */
+GmpVerifier *gmp_verifier_create(uint32_t x, uint32_t y, uint32_t z,
+                                 uint64_t A_max, uint64_t B_max) {
+  GmpVerifier *ver = (GmpVerifier *)calloc(1, sizeof(GmpVerifier));
+  if (!ver)
+    return NULL;
+  ver->x = x;
+  ver->y = y;
+  ver->z = z;
+
+  mpz_inits(ver->ax, ver->by, ver->sum, ver->root, NULL);
+  uint64_t C, g;
+  verifier_gmp(ver, A_max, B_max, 0, &C, &g);
+  return ver;
+}
+
+/**
+ * Check a pair in fixed width, or with the verifier's preallocated integers
+ * when the sum is too wide.
+ */
+bool gmp_verifier_check(GmpVerifier *ver, uint64_t A, uint64_t B,
+                        uint64_t C_max, uint64_t *out_C, uint64_t *out_gcd) {
+  if (A != ver->A_fixed) {
+    ver->ax_fits = pow_fixed(A, ver->x, &ver->ax_fixed);
+    ver->A_fixed = A;
+  }
+  bool decided = false;
+  bool hit = ver->ax_fits && fixed_check(&ver->ax_fixed, A, B, ver->y, ver->z,
+                                         C_max, out_C, out_gcd, &decided);
+  if (!decided)
+    return verifier_gmp(ver, A, B, C_max, out_C, out_gcd);
+
+#ifdef HG_VERIFY_CROSSCHECK
+  uint64_t C = 0, g = 0;
+  bool expect = verifier_gmp(ver, A, B, C_max, &C, &g);
+  if (expect != hit || (hit && (C != *out_C || g != *out_gcd))) {
+    fprintf(stderr,
+            "FATAL: Fixed-width verifier disagrees with GMP on %" PRIu64
+            "^%u + %" PRIu64 "^%u (z=%u)\n",
+            A, ver->x, B, ver->y, ver->z);
+    abort();
+  }
+#endif
+  return hit;
+}
+
+/**
+ * Free a verifier.
+ */
+void gmp_verifier_free(GmpVerifier *ver) {
+  if (!ver)
+    return;
+  mpz_clears(ver->ax, ver->by, ver->sum, ver->root, NULL);
+  free(ver);
 }
 
 /**
@@ -86,3 +338,57 @@ bool verify_beal_equation(uint64_t A, uint64_t B, uint64_t C, uint32_t x,
   mpz_clears(ax, by, cz, sum, NULL);
   return result;
 }
+
+/* ============================================================================
+ * EULER-CRITERION FILTER
+ * ============================================================================
+ */
+
+/**
+ * Initialize the Euler filter.
+ *
+ * Candidates are q = 1 (mod 2z) walking down from 2^61, so z divides q - 1
+ * and the nonzero z-th powers are exactly the s with s^((q-1)/z) = 1: each
+ * prime passes a random non-power with probability about 1/z.
+ */
+bool euler_filter_init(EulerFilter *filter, uint32_t z, int count) {
+  filter->count = 0;
+  if (count < 0 || count > MAX_EULER_PRIMES || z == 0)
+    return false;
+
+  uint64_t step = 2ULL * z;
+  uint64_t q = (1ULL << 61) - 1;
+  q -= (q - 1) % step;
+
+  for (; filter->count < count && q > step; q -= step) {
+    if (!is_prime64(q))
+      continue;
+
+    EulerPrime *p = &filter->primes[filter->count++];
+    mont64_init(&p->mont, q);
+    p->exponent = (q - 1) / z;
+  }
+  return filter->count == count;
+}
+
+/**
+ * Euler-criterion check of A^x + B^y modulo each filter prime.
+ */
+bool euler_filter_passes(const EulerFilter *filter, uint64_t A, uint64_t B,
+                         uint32_t x, uint32_t y) {
+  for (int i = 0; i < filter->count; i++) {
+    const Montgomery64 *mt = &filter->primes[i].mont;
+
+    uint64_t s = mont64_pow(mont64_to(A, mt), x, mt) +
+                 mont64_pow(mont64_to(B, mt), y, mt);
+    if (s >= mt->q)
+      s -= mt->q;
+
+    /* q | C is possible: a zero sum proves nothing */
+    if (s == 0)
+      continue;
+    if (mont64_pow(s, filter->primes[i].exponent, mt) != mt->one)
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,356 @@
+/**
+ * Instruction-set variants of the hot kernels.
+ *
+ * This file is compiled once per variant with that variant's -m flags and
+ * KERNEL_VARIANT set to its name (see CMakeLists.txt). Each copy exports one
+ * KernelSet, kernel_set_<variant>; kernel_select() picks among them at
+ * startup. Only the lane primitives below differ between variants, the
+ * kernels built on them are shared.
+ */
+
+#include "hyper_goliath.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#ifndef KERNEL_VARIANT
+#error "KERNEL_VARIANT must name the variant being compiled"
+#endif
+
+#define KERNEL_CAT2(a, b) a##b
+#define KERNEL_CAT(a, b) KERNEL_CAT2(a, b)
+
+/* ============================================================================
+ * LANE PRIMITIVES
+ * 32 byte lanes, one B each: lane_sums() forms (A^x + B^y) mod m from the
+ * periodic by_pow row, lane_members() tests the sums against a 128-bit residue
+ * mask and returns the lanes whose sum is a z-th power residue.
+ * ============================================================================
+ */
+
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+
+#define KERNEL_NAME "avx512"
+#define KERNEL_ISA KERNEL_ISA_AVX512
+
+typedef struct {
+  __m256i byte_idx; /* sum >> 3: the mask byte */
+  __m256i bit;      /* 1 << (sum & 7): the bit within it */
+} LaneSums;
+
+static inline void lane_sums(LaneSums *out, const uint8_t *by, uint8_t ax,
+                             uint8_t m) {
+  const __m256i bit_lut = _mm256_setr_epi8(
+      1, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16,
+      32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0);
+  __m256i sum = _mm256_add_epi8(_mm256_set1_epi8((char)ax),
+                                _mm256_loadu_si256((const __m256i *)by));
+  sum = _mm256_min_epu8(sum, _mm256_sub_epi8(sum, _mm256_set1_epi8((char)m)));
+  out->byte_idx = _mm256_and_si256(_mm256_srli_epi16(sum, 3),
+                                   _mm256_set1_epi8(0x0F));
+  out->bit = _mm256_shuffle_epi8(bit_lut,
+                                 _mm256_and_si256(sum, _mm256_set1_epi8(7)));
+}
+
+/* vptestmb yields the surviving lanes directly as a mask register */
+static inline uint32_t lane_members(const LaneSums *s, const uint64_t mask[2]) {
+  const __m256i mask_lut = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128((const __m128i *)mask));
+  return (uint32_t)_mm256_test_epi8_mask(
+      _mm256_shuffle_epi8(mask_lut, s->byte_idx), s->bit);
+}
+
+#elif defined(__AVX2__)
+
+#define KERNEL_NAME "avx2"
+#define KERNEL_ISA KERNEL_ISA_AVX2
+
+typedef struct {
+  __m256i byte_idx;
+  __m256i bit;
+} LaneSums;
+
+/* sum = ax + by; if (sum >= m) sum -= m; (sum - m wraps high when < m).
+ * The mask lookup takes two shuffles: one selects the mask byte (sum >> 3),
+ * the other the bit within it (sum & 7). */
+static inline void lane_sums(LaneSums *out, const uint8_t *by, uint8_t ax,
+                             uint8_t m) {
+  const __m256i bit_lut = _mm256_setr_epi8(
+      1, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16,
+      32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0);
+  __m256i sum = _mm256_add_epi8(_mm256_set1_epi8((char)ax),
+                                _mm256_loadu_si256((const __m256i *)by));
+  sum = _mm256_min_epu8(sum, _mm256_sub_epi8(sum, _mm256_set1_epi8((char)m)));
+  out->byte_idx = _mm256_and_si256(_mm256_srli_epi16(sum, 3),
+                                   _mm256_set1_epi8(0x0F));
+  out->bit = _mm256_shuffle_epi8(bit_lut,
+                                 _mm256_and_si256(sum, _mm256_set1_epi8(7)));
+}
+
+static inline uint32_t lane_members(const LaneSums *s, const uint64_t mask[2]) {
+  const __m256i mask_lut = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128((const __m128i *)mask));
+  __m256i hit =
+      _mm256_and_si256(_mm256_shuffle_epi8(mask_lut, s->byte_idx), s->bit);
+  __m256i killed = _mm256_cmpeq_epi8(hit, _mm256_setzero_si256());
+  return ~(uint32_t)_mm256_movemask_epi8(killed);
+}
+
+#elif defined(__SSE4_1__)
+
+#define KERNEL_NAME "sse4.1"
+#define KERNEL_ISA KERNEL_ISA_SSE41
+
+/* The AVX2 scheme on two 16-lane halves */
+typedef struct {
+  __m128i byte_idx[2];
+  __m128i bit[2];
+} LaneSums;
+
+static inline void lane_sums(LaneSums *out, const uint8_t *by, uint8_t ax,
+                             uint8_t m) {
+  const __m128i bit_lut =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 0, 0, 0, 0, 0, 0, 0, 0);
+  for (int h = 0; h < 2; h++) {
+    __m128i sum = _mm_add_epi8(_mm_set1_epi8((char)ax),
+                               _mm_loadu_si128((const __m128i *)by + h));
+    sum = _mm_min_epu8(sum, _mm_sub_epi8(sum, _mm_set1_epi8((char)m)));
+    out->byte_idx[h] =
+        _mm_and_si128(_mm_srli_epi16(sum, 3), _mm_set1_epi8(0x0F));
+    out->bit[h] =
+        _mm_shuffle_epi8(bit_lut, _mm_and_si128(sum, _mm_set1_epi8(7)));
+  }
+}
+
+static inline uint32_t lane_members(const LaneSums *s, const uint64_t mask[2]) {
+  const __m128i mask_lut = _mm_loadu_si128((const __m128i *)mask);
+  uint32_t killed = 0;
+  for (int h = 0; h < 2; h++) {
+    __m128i hit =
+        _mm_and_si128(_mm_shuffle_epi8(mask_lut, s->byte_idx[h]), s->bit[h]);
+    killed |= (uint32_t)_mm_movemask_epi8(
+                  _mm_cmpeq_epi8(hit, _mm_setzero_si128()))
+              << (16 * h);
+  }
+  return ~killed;
+}
+
+#else
+
+#define KERNEL_NAME "baseline"
+#define KERNEL_ISA KERNEL_ISA_BASELINE
+
+typedef struct {
+  uint8_t sum[32];
+} LaneSums;
+
+static inline void lane_sums(LaneSums *out, const uint8_t *by, uint8_t ax,
+                             uint8_t m) {
+  for (int l = 0; l < 32; l++) {
+    uint32_t sum = (uint32_t)ax + by[l];
+    out->sum[l] = (uint8_t)(sum >= m ? sum - m : sum);
+  }
+}
+
+static inline uint32_t lane_members(const LaneSums *s, const uint64_t mask[2]) {
+  uint32_t members = 0;
+  for (int l = 0; l < 32; l++)
+    members |= (uint32_t)get_bit128(mask, s->sum[l]) << l;
+  return members;
+}
+
+#endif
+
+/* ============================================================================
+ * KERNELS
+ * ============================================================================
+ */
+
+/**
+ * Lanes of [B_start, B_start + 32) that are <= B_max.
+ */
+static inline uint32_t lanes_in_range(uint64_t B_start,
+                                      const PrecomputedData *data) {
+  if (B_start + 31 <= data->B_max)
+    return 0xFFFFFFFFu;
+  uint64_t live = data->B_max >= B_start ? data->B_max - B_start + 1 : 0;
+  return live >= 32 ? 0xFFFFFFFFu : (uint32_t)((1ULL << live) - 1);
+}
+
+/**
+ * Sieve check for 32 B values at once.
+ *
+ * Relies on every byte-tier modulus being <= 128 (sums fit a byte, the mask
+ * fits one 16-byte shuffle table) and on the periodic by_pow rows extending
+ * SIEVE_LANE_PAD past m, so the 32 lanes load from B_start mod m onward.
+ * CRT-fused groups are not used here: their moduli exceed a byte lane and
+ * would need gathers, so every modulus is tested directly.
+ * Wide-tier moduli are checked per surviving lane.
+ */
+static uint32_t survives_32(uint64_t A, uint64_t B_start,
+                            const PrecomputedData *data) {
+  uint32_t survivors = lanes_in_range(B_start, data);
+
+  for (int t = 0; t < data->num_moduli && survivors; t++) {
+    int i = data->order[t];
+    LaneSums sums;
+    lane_sums(&sums, data->by_pow[i] + sieve_b_offset(data, i, B_start),
+              (uint8_t)sieve_ax(data, i, A), (uint8_t)data->moduli[i]);
+    survivors &= lane_members(&sums, data->residue_masks[i]);
+  }
+
+  /* Wide tier on the (rare) byte-tier survivors */
+  if (data->num_wide) {
+    for (uint32_t live = survivors; live; live &= live - 1) {
+      int l = __builtin_ctz(live);
+      if (!sieve_wide_survives(A, B_start + l, data))
+        survivors &= ~(1u << l);
+    }
+  }
+  return survivors;
+}
+
+/**
+ * z-family check for 32 B values at once: each modulus's sums are formed
+ * once and looked up in every family member's residue mask. A modulus is
+ * skipped once all signatures are dead in all lanes.
+ */
+static void family_32(uint64_t A, uint64_t B_start,
+                      const PrecomputedData *data, uint32_t *survivors) {
+  const ZFamily *fam = &data->family;
+  uint32_t live = lanes_in_range(B_start, data);
+  for (int k = 0; k < fam->count; k++)
+    survivors[k] = live;
+
+  for (int t = 0; t < data->num_moduli && live; t++) {
+    int i = data->order[t];
+    LaneSums sums;
+    lane_sums(&sums, data->by_pow[i] + sieve_b_offset(data, i, B_start),
+              (uint8_t)sieve_ax(data, i, A), (uint8_t)data->moduli[i]);
+
+    live = 0;
+    for (int k = 0; k < fam->count; k++) {
+      if (!survivors[k])
+        continue;
+      survivors[k] &= lane_members(&sums, fam->residue_masks[k][i]);
+      live |= survivors[k];
+    }
+  }
+
+  /* Wide tier per lane that is still alive for some signature */
+  if (data->num_wide) {
+    for (; live; live &= live - 1) {
+      int l = __builtin_ctz(live);
+      uint32_t alive = 0;
+      for (int k = 0; k < fam->count; k++)
+        alive |= ((survivors[k] >> l) & 1) << k;
+      alive = sieve_family_wide(A, B_start + l, data, alive);
+      for (int k = 0; k < fam->count; k++)
+        survivors[k] &= ~((uint32_t)!((alive >> k) & 1) << l);
+    }
+  }
+}
+
+/**
+ * Binary GCD, as gcd64(); BMI variants get tzcnt for the trailing-zero
+ * counts.
+ */
+static uint64_t gcd(uint64_t a, uint64_t b) {
+  if (a == 0)
+    return b;
+  if (b == 0)
+    return a;
+
+  int shift = __builtin_ctzll(a | b);
+  a >>= __builtin_ctzll(a);
+  do {
+    b >>= __builtin_ctzll(b);
+    if (a > b) {
+      uint64_t t = a;
+      a = b;
+      b = t;
+    }
+    b -= a;
+  } while (b);
+  return a << shift;
+}
+
+/* ============================================================================
+ * POWER TABLES
+ * ============================================================================
+ */
+
+#define POW_BLOCK 64
+
+/**
+ * r[j] = b[j]^e mod m for one block of bases. Every lane shares the
+ * exponent, so each square-and-multiply step is a straight Barrett loop
+ * over the block that vectorizes for this variant's instruction set.
+ */
+static void pow_block(uint32_t *restrict r, const uint32_t *restrict b,
+                      uint32_t e, Barrett16 br) {
+  if (e == 0) {
+    for (int j = 0; j < POW_BLOCK; j++)
+      r[j] = 1;
+    return;
+  }
+  for (int j = 0; j < POW_BLOCK; j++)
+    r[j] = b[j];
+  for (int bit = 30 - __builtin_clz(e); bit >= 0; bit--) {
+    for (int j = 0; j < POW_BLOCK; j++)
+      r[j] = barrett16_mul(r[j], r[j], br);
+    if ((e >> bit) & 1) {
+      for (int j = 0; j < POW_BLOCK; j++)
+        r[j] = barrett16_mul(r[j], b[j], br);
+    }
+  }
+}
+
+/**
+ * v^e mod m for v < count into out8 or out16 (whichever is non-NULL).
+ */
+static void pow_fill(uint8_t *out8, uint16_t *out16, uint64_t count,
+                     uint32_t e, uint32_t m) {
+  Barrett16 br = barrett16_init(m);
+  uint32_t base[POW_BLOCK], r[POW_BLOCK];
+  uint32_t c = 0; /* v mod m, carried across blocks */
+
+  for (uint64_t v = 0; v < count; v += POW_BLOCK) {
+    for (int j = 0; j < POW_BLOCK; j++) {
+      base[j] = c;
+      c = c + 1 == m ? 0 : c + 1;
+    }
+    pow_block(r, base, e, br);
+
+    int n = count - v < POW_BLOCK ? (int)(count - v) : POW_BLOCK;
+    if (out8) {
+      for (int j = 0; j < n; j++)
+        out8[v + j] = (uint8_t)r[j];
+    } else {
+      for (int j = 0; j < n; j++)
+        out16[v + j] = (uint16_t)r[j];
+    }
+  }
+}
+
+static void pow_table8(uint8_t *out, uint64_t count, uint32_t e, uint32_t m) {
+  pow_fill(out, NULL, count, e, m);
+}
+
+static void pow_table16(uint16_t *out, uint64_t count, uint32_t e,
+                        uint32_t m) {
+  pow_fill(NULL, out, count, e, m);
+}
+
+const KernelSet KERNEL_CAT(kernel_set_, KERNEL_VARIANT) = {
+    .name = KERNEL_NAME,
+    .isa = KERNEL_ISA,
+    .survives_32 = survives_32,
+    .family_32 = family_32,
+    .gcd = gcd,
+    .pow_table8 = pow_table8,
+    .pow_table16 = pow_table16,
+};
@@ -6,6 +6,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/utsname.h>
 #include <time.h>
 #include <unistd.h>
@@ -21,8 +22,12 @@ void get_timestamp_iso(char *buf, size_t len) {
 
 /**
  * Log the START event.
+ * data describes the sieve tables actually in use (may be NULL).
+ * precompute_seconds is the wall time spent building them.
  */
-void log_start(const char *path, const SearchParams *params, int num_workers) {
+void log_start(const char *path, const SearchParams *params,
+               const PrecomputedData *data, int num_workers,
+               double precompute_seconds) {
   if (!path)
     return;
   FILE *f = fopen(path, "w");
@@ -41,6 +46,15 @@ void log_start(const char *path, const SearchParams *params, int num_workers) {
   uint64_t expected_pairs = (params->A_max - params->A_start + 1) *
                             (params->B_max - params->B_start + 1);
 
+  /* Peak resident set so far, i.e. after every table is built. ru_maxrss
+   * is in KiB on Linux but in bytes on macOS. */
+  struct rusage usage;
+  long peak_rss_kb = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+#ifdef __APPLE__
+  peak_rss_kb /= 1024;
+#endif
+  size_t table_bytes = data ? precompute_table_bytes(data) : 0;
+
   fprintf(f,
           "{\"ts\":\"%s\",\"event\":\"START\",\"run_id\":%" PRIu64 ","
           "\"mode\":\"search\",\"signature\":[%u,%u,%u],"
@@ -49,12 +63,36 @@ void log_start(const char *path, const SearchParams *params, int num_workers) {
           "\"Cmax\":%" PRIu64 ",\"expected_pairs\":%" PRIu64 ","
           "\"system\":{\"hostname\":\"%s\",\"platform\":\"%s %s\","
           "\"cpu_count\":%d,\"engine\":\"hyper_goliath_c\"},"
-          "\"sieve_primes\":[2,3,5,7,11,13,17,19,23,29,31,37,41,43,47,53,59,61,"
-          "67,71]}\n",
+          "\"sieve_mode\":\"%s\",\"kernel\":\"%s\","
+          "\"precompute_seconds\":%.3f,\"table_bytes\":%zu,"
+          "\"peak_rss_kb\":%ld,",
           ts, (uint64_t)time(NULL), params->x, params->y, params->z,
           params->A_start, params->A_max, params->B_start, params->B_max,
           params->C_max, expected_pairs, hostname, uname_info.sysname,
-          uname_info.release, num_workers);
+          uname_info.release, num_workers,
+          sieve_mode_name(params->sieve_mode), kernel_active()->name,
+          precompute_seconds, table_bytes, peak_rss_kb);
+
+  if (data && data->num_fused > 0) {
+    fprintf(f, "\"fused_moduli\":[");
+    for (int g = 0; g < data->num_fused; g++)
+      fprintf(f, "%s%u", g ? "," : "", data->fused[g].modulus);
+    fprintf(f, "],");
+  }
+
+  /* Key kept as "sieve_primes" for Python tooling; prime powers may appear */
+  fprintf(f, "\"sieve_primes\":[");
+  if (data) {
+    for (int i = 0; i < data->num_moduli; i++)
+      fprintf(f, "%s%u", i ? "," : "", data->moduli[i]);
+    for (int i = 0; i < data->num_wide; i++)
+      fprintf(f, "%s%u", (i || data->num_moduli) ? "," : "",
+              data->wide[i].modulus);
+  } else {
+    for (int i = 0; i < NUM_SIEVE_PRIMES; i++)
+      fprintf(f, "%s%u", i ? "," : "", SIEVE_PRIMES[i]);
+  }
+  fprintf(f, "]}\n");
 
   fclose(f);
 }
@@ -134,7 +172,9 @@ void log_complete(const char *path, uint64_t run_id, const SearchParams *params,
   hash ^= params->C_max;
   hash *= FNV_PRIME;
 
-  /* Include all results for verification */
+  /* Include all results for verification. deep_filtered and euler_filtered
+   * are left out: they split exact_checks without changing which pairs were
+   * searched. */
   hash ^= results->total_pairs;
   hash *= FNV_PRIME;
   hash ^= results->gcd_filtered;
@@ -159,6 +199,7 @@ void log_complete(const char *path, uint64_t run_id, const SearchParams *params,
       ",%" PRIu64 "],\"C\":[1,%" PRIu64 "]},"
       "\"results\":{\"total_pairs\":%" PRIu64 ",\"gcd_filtered\":%" PRIu64 ","
       "\"mod_filtered\":%" PRIu64 ",\"exact_checks\":%" PRIu64 ","
+      "\"deep_filtered\":%" PRIu64 ",\"euler_filtered\":%" PRIu64 ","
       "\"power_hits\":%" PRIu64 ",\"primitive_counterexamples\":%" PRIu64 "},"
       "\"performance\":{\"runtime_seconds\":%.2f,"
       "\"avg_rate_pairs_per_sec\":%.0f,\"workers_used\":%d},"
@@ -167,13 +208,43 @@ void log_complete(const char *path, uint64_t run_id, const SearchParams *params,
       ts, run_id, params->x, params->y, params->z, params->A_start,
       params->A_max, params->B_start, params->B_max, params->C_max,
       results->total_pairs, results->gcd_filtered, results->mod_filtered,
-      results->exact_checks, results->power_hits, results->primitive_hits,
+      results->exact_checks, results->deep_filtered, results->euler_filtered,
+      results->power_hits, results->primitive_hits,
       results->runtime_seconds, results->rate_pairs_per_sec,
       params->num_threads > 0 ? params->num_threads : 1, status, hash);
 
   fclose(f);
 }
 
+/**
+ * Log a SIEVE_ORDER event: the modulus test order chosen from sampled kill
+ * rates, effective from row A_from onwards.
+ */
+void log_sieve_order(const char *path, uint64_t run_id, uint64_t A_from,
+                     const SieveProfile *profile) {
+  if (!path)
+    return;
+  FILE *f = fopen(path, "a");
+  if (!f)
+    return;
+
+  char ts[32];
+  get_timestamp_iso(ts, sizeof(ts));
+
+  fprintf(f,
+          "{\"ts\":\"%s\",\"event\":\"SIEVE_ORDER\",\"run_id\":%" PRIu64
+          ",\"A_from\":%" PRIu64 ",\"sampled_pairs\":%" PRIu64 ",\"order\":[",
+          ts, run_id, A_from, profile->sampled_pairs);
+  for (int i = 0; i < profile->count; i++)
+    fprintf(f, "%s%u", i ? "," : "", profile->moduli[i]);
+  fprintf(f, "],\"kill_rates\":[");
+  for (int i = 0; i < profile->count; i++)
+    fprintf(f, "%s%.6f", i ? "," : "", profile->kill_rate[i]);
+  fprintf(f, "]}\n");
+
+  fclose(f);
+}
+
 /**
  * Log a power hit.
  */
@@ -9,16 +9,38 @@
  */
 
 #include "hyper_goliath.h"
+#include <dirent.h>
 #include <getopt.h>
+#include <gmp.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 /* Version info */
 #define VERSION "1.0.0"
 
+/* GMP allocations seen while the counting allocator is installed */
+static uint64_t gmp_allocations = 0;
+
+static void *counting_alloc(size_t n) {
+  gmp_allocations++;
+  return malloc(n);
+}
+
+static void *counting_realloc(void *p, size_t old_size, size_t n) {
+  (void)old_size;
+  gmp_allocations++;
+  return realloc(p, n);
+}
+
+static void counting_free(void *p, size_t n) {
+  (void)n;
+  free(p);
+}
+
 /**
  * Print usage information.
  */
@@ -31,7 +53,8 @@ static void print_usage(const char *prog) {
   printf("Required:\n");
   printf("  --x <N>          Exponent x (must be > 2)\n");
   printf("  --y <N>          Exponent y (must be > 2)\n");
-  printf("  --z <N>          Exponent z (must be > 2)\n");
+  printf("  --z <N>          Exponent z (must be > 2), or a list such as\n");
+  printf("                   11,13 for one z-family pass (lanes sieve)\n");
   printf("\n");
   printf("Bounds:\n");
   printf("  --Amax <N>       Maximum A value (default: 1000)\n");
@@ -44,6 +67,25 @@ static void print_usage(const char *prog) {
   printf("  --threads <N>    Number of threads (default: auto)\n");
   printf("  --log <file>     JSONL log file path\n");
   printf("  --progress <N>   Print progress every N pairs (0=disabled)\n");
+  printf("  --sieve <mode>   Sieve kernel: lanes (default), rows, tiered\n");
+  printf("                   wheel or sliced\n");
+  printf("  --fused          Test fused prime groups (210, 143, 323) first\n");
+  printf("                   (scalar and rows kernels)\n");
+  printf("  --moduli <list>  Sieve moduli: primes (default), powers,\n");
+  printf("                   adaptive[:K] (K best primes for z), or a\n");
+  printf("                   comma list of values in [2,65535], or\n");
+  printf("                   @FILE (list written by find_moduli --out)\n");
+  printf("  --reorder <N>    Re-profile the modulus test order every N rows\n");
+  printf("  --deep <N>       Extra primes tested on survivors before GMP\n");
+  printf("                   (default: %d, 0 = off)\n", DEEP_BANK_DEFAULT);
+  printf("  --euler <N>      61-bit primes for the Euler z-th power test\n");
+  printf("                   before GMP (default: %d, 0 = off)\n",
+         EULER_FILTER_DEFAULT);
+  printf("  --kernel <name>  Kernel variant: auto (default, best the CPU\n");
+  printf("                   supports), baseline, sse4.1, avx2, avx512\n");
+  printf("  --cache <dir>    Map the wheel and deep-bank tables from <dir>,\n");
+  printf("                   building and storing them on a miss (<dir>\n");
+  printf("                   is created if missing)\n");
   printf("  --validate       Run self-validation tests and exit\n");
   printf("  --help           Show this help\n");
   printf("\n");
@@ -52,6 +94,61 @@ static void print_usage(const char *prog) {
   printf("\n");
 }
 
+/**
+ * Parse --z: one exponent, or a comma list of distinct exponents for a
+ * z-family run (params->z is set to the first).
+ */
+static bool parse_z_family(const char *spec, SearchParams *params) {
+  int n = 0;
+  const char *cur = spec;
+  for (;;) {
+    char *end;
+    unsigned long z = strtoul(cur, &end, 10);
+    if (end == cur || z > UINT32_MAX || n == MAX_Z_FAMILY)
+      return false;
+    for (int k = 0; k < n; k++) {
+      if (params->z_family[k] == z)
+        return false;
+    }
+    params->z_family[n++] = (uint32_t)z;
+    if (*end == '\0')
+      break;
+    if (*end != ',')
+      return false;
+    cur = end + 1;
+  }
+  params->z = params->z_family[0];
+  params->num_z = n;
+  return true;
+}
+
+/**
+ * Parse --moduli @FILE: the first line that is not blank or a '#' comment
+ * holds the comma list (as written by find_moduli --out).
+ */
+static bool parse_moduli_file(const char *path, SearchParams *params) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "Error: Cannot open moduli file '%s'\n", path);
+    return false;
+  }
+
+  char line[4096];
+  bool ok = false;
+  while (fgets(line, sizeof(line), f)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '#' || line[0] == '\0')
+      continue;
+    ok = sieve_moduli_parse(line, params->moduli, &params->num_moduli);
+    break;
+  }
+  fclose(f);
+
+  if (!ok)
+    fprintf(stderr, "Error: No valid moduli list in '%s'\n", path);
+  return ok;
+}
+
 /**
  * Run self-validation tests.
  */
@@ -127,13 +224,61 @@ static int run_validation(void) {
   uint64_t pm2 = powmod(3, 4, 7);     /* 81 mod 7 = 4 */
   uint64_t pm3 = powmod(5, 3, 13);    /* 125 mod 13 = 8 */
 
-  if (pm1 != 24 || pm2 != 4 || pm3 != 8) {
+  /* (2^33 + 1)^2 = 2^66 + 2^34 + 1: the square overflows 64 bits */
+  uint64_t pm4 = powmod((1ULL << 33) + 1, 2, 1ULL << 34);
+
+  if (pm1 != 24 || pm2 != 4 || pm3 != 8 || pm4 != 1) {
     printf("    FAIL: powmod results incorrect\n");
     errors++;
   } else {
     printf("    PASS: Modular exponentiation correct\n");
   }
 
+  /* Batched Barrett tables in every variant, Montgomery against powmod64 */
+  {
+    const KernelSet *variants[KERNEL_ISA_AVX512 + 1];
+    int num_variants = kernel_available(variants);
+    static const uint32_t table_moduli[] = {2, 71, 128, 331, 65521, 65536};
+    static const uint32_t exps[] = {0, 1, 2, 5, 13};
+    static uint16_t table16[70000];
+    uint8_t table8[1000];
+    uint64_t mismatches = 0;
+    for (int k = 0; k < num_variants; k++) {
+      for (int t = 0; t < 6; t++) {
+        uint32_t m = table_moduli[t];
+        for (int j = 0; j < 5; j++) {
+          uint32_t e = exps[j];
+          variants[k]->pow_table16(table16, 70000, e, m);
+          for (uint32_t v = 0; v < 70000; v++)
+            mismatches += table16[v] != powmod(v, e, m);
+          if (m > 256)
+            continue;
+          variants[k]->pow_table8(table8, 1000, e, m);
+          for (uint32_t v = 0; v < 1000; v++)
+            mismatches += table8[v] != powmod(v, e, m);
+        }
+      }
+    }
+
+    Montgomery64 mt;
+    uint64_t q = (1ULL << 61) - 1;
+    bool mont_ok = mont64_init(&mt, q) && !mont64_init(&mt, 1ULL << 40);
+    mont64_init(&mt, q);
+    for (uint64_t a = 1; a < 1ULL << 60 && mont_ok; a = a * 7 + 3) {
+      uint64_t r = mont64_mul(mont64_pow(mont64_to(a, &mt), a, &mt), 1, &mt);
+      mont_ok = r == powmod64(a, a, q);
+    }
+
+    if (mismatches || !mont_ok) {
+      printf("    FAIL: %" PRIu64 " table mismatches, Montgomery %s\n",
+             mismatches, mont_ok ? "ok" : "wrong");
+      errors++;
+    } else {
+      printf("    PASS: Barrett tables (%d variants) and Montgomery agree\n",
+             num_variants);
+    }
+  }
+
   /* Test 4: GMP verification */
   printf("\n[4] Testing GMP exact verification...\n");
 
@@ -179,6 +324,812 @@ static int run_validation(void) {
     precompute_free(data);
   }
 
+  /* Test 6: Every usable kernel variant must agree with the scalar sieve */
+  printf("\n[6] Testing kernel variants against scalar...\n");
+
+  data = precompute_create(3, 5, 7, 300, 300);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    const KernelSet *variants[KERNEL_ISA_AVX512 + 1];
+    int num_variants = kernel_available(variants);
+    for (int v = 0; v < num_variants; v++) {
+      const KernelSet *ks = variants[v];
+      uint64_t mismatches = 0;
+      for (uint64_t A = 1; A <= 300; A++) {
+        for (uint64_t B = 1; B <= 300; B += 32) {
+          uint32_t lanes = ks->survives_32(A, B, data);
+          for (int l = 0; l < 32; l++) {
+            bool expect =
+                B + l <= 300 && sieve_survives_scalar(A, B + l, data);
+            if (expect != ((lanes >> l) & 1))
+              mismatches++;
+            if (ks->gcd(A, B + l) != gcd64(A, B + l))
+              mismatches++;
+          }
+        }
+      }
+      uint8_t table[300];
+      ks->pow_table8(table, 300, 5, 71);
+      for (uint32_t r = 0; r < 300; r++)
+        mismatches += table[r] != powmod(r, 5, 71);
+
+      if (mismatches) {
+        printf("    FAIL: %s: %" PRIu64 " mismatches\n", ks->name,
+               mismatches);
+        errors++;
+      } else {
+        printf("    PASS: %s kernels match scalar on [1,300]x[1,300]\n",
+               ks->name);
+      }
+    }
+    precompute_free(data);
+  }
+
+  /* Test 7: Row-bitmap kernel must agree bit-for-bit with the scalar sieve */
+  printf("\n[7] Testing row-bitmap sieve against scalar...\n");
+
+  data = precompute_create(3, 4, 13, 400, 5000);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0;
+    uint64_t bits[SIEVE_ROW_WORDS];
+    for (uint64_t A = 1; A <= 400; A += 7) {
+      for (uint64_t B0 = 3; B0 <= 5000; B0 += SIEVE_ROW_BLOCK) {
+        sieve_row_bitmap(A, B0, SIEVE_ROW_WORDS, bits, data);
+        for (uint64_t k = 0; k < SIEVE_ROW_BLOCK && B0 + k <= 5000; k++) {
+          bool got = (bits[k >> 6] >> (k & 63)) & 1;
+          if (got != sieve_survives_scalar(A, B0 + k, data))
+            mismatches++;
+        }
+      }
+    }
+    if (mismatches) {
+      printf("    FAIL: %" PRIu64 " bit mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: Row bitmaps match scalar for (3,4,13)\n");
+    }
+    precompute_free(data);
+  }
+
+  /* Test 8: CRT-fused groups must not change which pairs survive */
+  printf("\n[8] Testing CRT-fused pair tables...\n");
+
+  data = precompute_create(3, 5, 7, 500, 500);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    static bool plain[501][501];
+    for (uint64_t A = 1; A <= 500; A++)
+      for (uint64_t B = 1; B <= 500; B++)
+        plain[A][B] = sieve_survives_scalar(A, B, data);
+
+    uint64_t mismatches = 0;
+    if (!precompute_build_fused(data)) {
+      mismatches++;
+    } else {
+      uint64_t bits[SIEVE_ROW_WORDS];
+      for (uint64_t A = 1; A <= 500; A++) {
+        sieve_row_bitmap(A, 1, SIEVE_ROW_WORDS, bits, data);
+        for (uint64_t B = 1; B <= 500; B++) {
+          bool row_bit = (bits[(B - 1) >> 6] >> ((B - 1) & 63)) & 1;
+          if (sieve_survives_scalar(A, B, data) != plain[A][B] ||
+              row_bit != plain[A][B])
+            mismatches++;
+        }
+      }
+    }
+    if (mismatches) {
+      printf("    FAIL: %" PRIu64 " fused mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: Fused groups match per-prime sieve for (3,5,7)\n");
+    }
+    precompute_free(data);
+  }
+
+  /* Test 9: Prime-power moduli */
+  printf("\n[9] Testing prime-power moduli...\n");
+
+  /* Cubes mod 9 should be {0, 1, 8} */
+  uint64_t mask_9_3[2];
+  compute_residue_mask128(9, 3, mask_9_3);
+  if (mask_9_3[0] != ((1ULL << 0) | (1ULL << 1) | (1ULL << 8)) ||
+      mask_9_3[1] != 0) {
+    printf("    FAIL: Cubes mod 9 = 0x%" PRIx64 ":%" PRIx64 "\n", mask_9_3[1],
+           mask_9_3[0]);
+    errors++;
+  } else {
+    printf("    PASS: Cubes mod 9 = {0, 1, 8}\n");
+  }
+
+  /* Every prime-power survivor must also survive the plain primes */
+  uint32_t powers[MAX_SIEVE_MODULI];
+  int num_powers = 0;
+  sieve_moduli_parse("powers", powers, &num_powers);
+  data = precompute_create(3, 5, 7, 300, 300);
+  PrecomputedData *pdata =
+      precompute_create_moduli(3, 5, 7, 300, 300, powers, num_powers);
+  if (!data || !pdata) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t escaped = 0;
+    for (uint64_t A = 1; A <= 300; A++)
+      for (uint64_t B = 1; B <= 300; B++)
+        if (sieve_survives_scalar(A, B, pdata) &&
+            !sieve_survives_scalar(A, B, data))
+          escaped++;
+    uint64_t n_primes = count_sieve_survivors(1, 300, 1, 300, data);
+    uint64_t n_powers = count_sieve_survivors(1, 300, 1, 300, pdata);
+    if (escaped) {
+      printf("    FAIL: %" PRIu64 " pairs survive powers but not primes\n",
+             escaped);
+      errors++;
+    } else {
+      printf("    PASS: (3,5,7) survivors: primes=%" PRIu64
+             ", powers=%" PRIu64 "\n",
+             n_primes, n_powers);
+    }
+  }
+  precompute_free(data);
+  precompute_free(pdata);
+
+  /* Test 10: Adaptive selection and the wide (16-bit) tier */
+  printf("\n[10] Testing adaptive moduli and wide tier...\n");
+
+  uint32_t adaptive[MAX_MODULI_LIST];
+  int num_adaptive = sieve_moduli_adaptive(7, 12, adaptive);
+  /* Sparsest 7th-power residues: p = 1 (mod 7), smallest first */
+  if (num_adaptive != 12 || adaptive[0] != 29 || adaptive[1] != 43 ||
+      adaptive[2] != 71) {
+    printf("    FAIL: Adaptive moduli for z=7 do not start 29, 43, 71\n");
+    errors++;
+  } else {
+    printf("    PASS: Adaptive moduli for z=7 start 29, 43, 71\n");
+  }
+
+  data = precompute_create_moduli(3, 5, 7, 400, 400, adaptive, num_adaptive);
+  if (!data || data->num_wide == 0) {
+    printf("    FAIL: Precomputation failed or no wide moduli\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0;
+    uint64_t bits[SIEVE_ROW_WORDS];
+    for (uint64_t A = 1; A <= 400; A++) {
+      sieve_row_bitmap(A, 1, 7, bits, data);
+      for (uint64_t B = 1; B <= 400; B++) {
+        uint64_t k = B - 1;
+        bool expect = sieve_survives_scalar(A, B, data);
+        if (expect != ((bits[k >> 6] >> (k & 63)) & 1))
+          mismatches++;
+        if (k % 32 == 0) {
+          uint32_t lanes = kernel_active()->survives_32(A, B, data);
+          for (int l = 0; l < 32 && B + l <= 400; l++)
+            if (((lanes >> l) & 1) != sieve_survives_scalar(A, B + l, data))
+              mismatches++;
+        }
+      }
+    }
+    if (mismatches) {
+      printf("    FAIL: %" PRIu64 " wide-tier mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: %d byte + %d wide moduli agree across kernels\n",
+             data->num_moduli, data->num_wide);
+    }
+  }
+  precompute_free(data);
+
+  /* Test 11: Profiled test order must not change which pairs survive */
+  printf("\n[11] Testing profiled modulus order...\n");
+
+  data = precompute_create(3, 4, 11, 400, 400);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t before = count_sieve_survivors(1, 400, 1, 400, data);
+    SieveProfile profile;
+    sieve_profile_order(data, 1, 400, 1, 400, &profile);
+    uint64_t after = count_sieve_survivors(1, 400, 1, 400, data);
+    if (before != after || profile.count != NUM_SIEVE_PRIMES) {
+      printf("    FAIL: survivors %" PRIu64 " -> %" PRIu64 "\n", before, after);
+      errors++;
+    } else {
+      printf("    PASS: Order starts %u (kills %.1f%%), survivors unchanged\n",
+             profile.moduli[0], 100.0 * profile.kill_rate[0]);
+    }
+    precompute_free(data);
+  }
+
+  /* Test 12: Tiered sieve survivors and coprime counting */
+  printf("\n[12] Testing tiered sieve and coprime counts...\n");
+
+  data = precompute_create(3, 4, 13, 600, 600);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0;
+    uint64_t bits[SIEVE_ROW_WORDS];
+    uint32_t idx[SIEVE_ROW_BLOCK];
+    for (uint64_t A = 1; A <= 600; A++) {
+      /* B in [7, 600]: 594 values, last word partial */
+      sieve_row_prefix(A, 7, 10, bits, data, SIEVE_TIER1_MODULI);
+      bits[9] &= (1ULL << (594 - 9 * 64)) - 1;
+      size_t n = sieve_compact_bits(bits, 10, idx);
+      n = sieve_filter_compact(A, 7, idx, n, data, SIEVE_TIER1_MODULI);
+
+      size_t s = 0;
+      uint64_t coprime = 0;
+      for (uint64_t B = 7; B <= 600; B++) {
+        bool expect = sieve_survives_scalar(A, B, data);
+        bool got = s < n && idx[s] == B - 7;
+        s += got;
+        mismatches += expect != got;
+        coprime += gcd64(A, B) == 1;
+      }
+      mismatches += coprime != count_coprime_range(A, 7, 600);
+    }
+    if (mismatches) {
+      printf("    FAIL: %" PRIu64 " tiered/coprime mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: Tiered survivors and coprime counts match\n");
+    }
+    precompute_free(data);
+  }
+
+  /* Test 13: Every coprime sieve survivor lies in a live wheel class */
+  printf("\n[13] Testing residue-class wheel...\n");
+
+  data = precompute_create(3, 4, 13, 600, 600);
+  if (!data || !precompute_build_wheel(data)) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    const SieveWheel *wh = &data->wheel;
+    uint64_t missed = 0;
+    for (uint64_t A = 1; A <= 600; A++) {
+      uint32_t a = (uint32_t)(A % wh->modulus);
+      for (uint64_t B = 1; B <= 600; B++) {
+        if (gcd64(A, B) > 1 || !sieve_survives_scalar(A, B, data))
+          continue;
+        bool live = false;
+        for (uint32_t c = wh->offsets[a]; c < wh->offsets[a + 1]; c++)
+          live |= wh->classes[c] == B % wh->modulus;
+        missed += !live;
+      }
+    }
+    if (missed || wh->offsets[wh->modulus] == 0) {
+      printf("    FAIL: %" PRIu64 " survivors in dead classes\n", missed);
+      errors++;
+    } else {
+      printf("    PASS: W=%u keeps all survivors (%u live classes)\n",
+             wh->modulus, wh->offsets[wh->modulus]);
+    }
+  }
+  precompute_free(data);
+
+  /* Test 14: Bit-sliced tiles must agree bit-for-bit with the scalar sieve */
+  printf("\n[14] Testing bit-sliced sieve against scalar...\n");
+
+  data = precompute_create_moduli(3, 5, 7, 300, 300, adaptive, num_adaptive);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0;
+    uint64_t words[300];
+    /* Tiles straddle A_max = 300 so the tail mask is exercised */
+    for (uint64_t A0 = 1; A0 <= 300; A0 += 64) {
+      sieve_sliced_tile(A0, 1, 300, words, data);
+      for (uint64_t j = 0; j < 300; j++) {
+        for (int k = 0; k < 64; k++) {
+          bool expect =
+              A0 + k <= 300 && sieve_survives_scalar(A0 + k, 1 + j, data);
+          mismatches += expect != ((words[j] >> k) & 1);
+        }
+      }
+    }
+    if (mismatches) {
+      printf("    FAIL: %" PRIu64 " bit-sliced mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: Bit-sliced tiles match scalar (wide tier included)\n");
+    }
+  }
+  precompute_free(data);
+
+  /* Test 15: Generated kernels must match the generic sieve */
+  printf("\n[15] Testing specialized sieve kernels...\n");
+
+  SieveKernelFn kernel = sieve_kernel_lookup(3, 5, 7);
+  if (!kernel) {
+    printf("    SKIP: No specialized kernel built for (3,5,7)\n");
+  } else {
+    data = precompute_create(3, 5, 7, 500, 500);
+    uint64_t mismatches = 0;
+    for (uint64_t A = 1; data && A <= 500; A++) {
+      for (uint64_t B = 1; B <= 500; B++)
+        mismatches += kernel(A, B) != sieve_survives_scalar(A, B, data);
+    }
+    if (!data || mismatches) {
+      printf("    FAIL: %" PRIu64 " specialized-kernel mismatches\n",
+             mismatches);
+      errors++;
+    } else {
+      printf("    PASS: Specialized (3,5,7) kernel matches scalar\n");
+    }
+    precompute_free(data);
+  }
+
+  /* Test 16: The deep bank must never reject a genuine power sum */
+  printf("\n[16] Testing deep survivor bank...\n");
+
+  /* (3,3,5) has non-coprime hits such as 3^3 + 6^3 = 3^5 */
+  data = precompute_create(3, 3, 5, 400, 400);
+  if (!data || !precompute_build_deep(data, 200)) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t hits = 0, lost = 0, survivors = 0, rejected = 0;
+    for (uint64_t A = 1; A <= 400; A++) {
+      for (uint64_t B = 1; B <= 400; B++) {
+        if (!sieve_survives_scalar(A, B, data))
+          continue;
+        survivors++;
+        uint64_t C, g;
+        bool hit = check_beal_hit_gmp(A, B, 3, 3, 5, 1000000, &C, &g);
+        bool deep = sieve_deep_survives(A, B, &data->deep);
+        hits += hit;
+        rejected += !deep;
+        lost += hit && !deep;
+      }
+    }
+    if (lost || hits == 0 || rejected == 0 || data->deep.count != 200) {
+      printf("    FAIL: Deep bank lost %" PRIu64 " of %" PRIu64 " hits\n",
+             lost, hits);
+      errors++;
+    } else {
+      printf("    PASS: Deep bank ruled out %" PRIu64 "/%" PRIu64
+             " survivors, kept all %" PRIu64 " hits\n",
+             rejected, survivors, hits);
+    }
+  }
+  precompute_free(data);
+
+  /* Test 17: Euler filter keeps real hits and rejects non-powers */
+  printf("\n[17] Testing Euler-criterion filter...\n");
+
+  EulerFilter euler;
+  if (!euler_filter_init(&euler, 5, 4)) {
+    printf("    FAIL: No filter primes found\n");
+    errors++;
+  } else {
+    /* 3^3 + 6^3 = 3^5 and 8^3 + 8^3 = 4^5 are genuine fifth powers */
+    bool kept = euler_filter_passes(&euler, 3, 6, 3, 3) &&
+                euler_filter_passes(&euler, 8, 8, 3, 3);
+    /* A non-power passes each prime with probability about 1/z, so about
+     * 1000 / 5^4 = 1.6 of these sums are expected to pass all four */
+    uint64_t passed = 0, tried = 0;
+    for (uint64_t A = 1000; A < 1100; A++) {
+      for (uint64_t B = 2000; B < 2010; B++) {
+        tried++;
+        passed += euler_filter_passes(&euler, A, B, 3, 3);
+      }
+    }
+    bool modulus_ok = true;
+    for (int i = 0; i < euler.count; i++)
+      modulus_ok &= euler.primes[i].mont.q < (1ULL << 61) &&
+                    euler.primes[i].mont.q % 5 == 1;
+    if (!kept || passed > tried / 100 || !modulus_ok) {
+      printf("    FAIL: kept=%d, %" PRIu64 "/%" PRIu64 " non-powers passed\n",
+             kept, passed, tried);
+      errors++;
+    } else {
+      printf("    PASS: Hits kept, %" PRIu64 "/%" PRIu64
+             " non-powers rejected\n",
+             tried - passed, tried);
+    }
+  }
+
+  /* Test 18: Prefix-pattern cache must not change any verdict */
+  printf("\n[18] Testing prefix-pattern cache...\n");
+
+  data = precompute_create(3, 5, 7, 600, 600);
+  if (!data) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    SieveProfile profile;
+    sieve_profile_order(data, 1, 600, 1, 600, &profile);
+    /* Sized as for a long sweep, so the cache is always worth building */
+    if (!precompute_build_prefix(data, 1ull << 32, 1ull << 32) ||
+        data->prefix.period == 0) {
+      printf("    FAIL: No prefix cache built\n");
+      errors++;
+    } else {
+      uint64_t mismatches = 0;
+      uint64_t bits[SIEVE_ROW_WORDS];
+      uint32_t idx[SIEVE_ROW_BLOCK];
+      for (uint64_t A = 1; A <= 600; A++) {
+        sieve_row_bitmap(A, 3, 10, bits, data);
+        sieve_row_prefix(A, 3, 10, bits + 10, data, SIEVE_TIER1_MODULI);
+        bits[19] &= (1ULL << (598 - 9 * 64)) - 1;
+        size_t n = sieve_compact_bits(bits + 10, 10, idx);
+        n = sieve_filter_compact(A, 3, idx, n, data, SIEVE_TIER1_MODULI);
+
+        size_t s = 0;
+        for (uint64_t B = 3; B <= 600; B++) {
+          uint64_t k = B - 3;
+          bool expect = sieve_survives_scalar(A, B, data);
+          bool tiered = s < n && idx[s] == k;
+          s += tiered;
+          mismatches += expect != ((bits[k >> 6] >> (k & 63)) & 1);
+          mismatches += expect != tiered;
+        }
+      }
+      if (mismatches) {
+        printf("    FAIL: %" PRIu64 " prefix-cache mismatches\n", mismatches);
+        errors++;
+      } else {
+        printf("    PASS: %u cached patterns (period %u) match scalar\n",
+               data->prefix.num_keys, data->prefix.period);
+      }
+    }
+  }
+  precompute_free(data);
+
+  /* Test 19: A z-family pass must match each signature's own sieve */
+  printf("\n[19] Testing z-family sieve...\n");
+
+  {
+    static const uint32_t fam_z[3] = {11, 13, 5};
+    uint32_t fam_moduli[MAX_MODULI_LIST];
+    int fam_count = 0;
+    sieve_moduli_parse("primes", fam_moduli, &fam_count);
+    fam_moduli[fam_count++] = 331; /* Wide tier: 331 = 1 (mod 11), (mod 5) */
+    fam_moduli[fam_count++] = 599; /* 599 = 1 (mod 13) */
+
+    data = precompute_create_moduli(3, 4, 11, 400, 400, fam_moduli, fam_count);
+    PrecomputedData *single[3] = {NULL, NULL, NULL};
+    const KernelSet *variants[KERNEL_ISA_AVX512 + 1];
+    int num_variants = kernel_available(variants);
+    bool ok = data && precompute_build_family(data, fam_z, 3, 0);
+    for (int k = 0; k < 3; k++) {
+      single[k] = precompute_create_moduli(3, 4, fam_z[k], 400, 400,
+                                           fam_moduli, fam_count);
+      ok = ok && single[k];
+    }
+
+    if (!ok) {
+      printf("    FAIL: Precomputation failed\n");
+      errors++;
+    } else {
+      uint64_t mismatches = 0, survivors[3] = {0, 0, 0};
+      for (uint64_t A = 1; A <= 400; A++) {
+        for (uint64_t B = 1; B <= 400; B++) {
+          uint32_t alive = sieve_family_scalar(A, B, data);
+          for (int k = 0; k < 3; k++) {
+            bool expect = sieve_survives_scalar(A, B, single[k]);
+            survivors[k] += expect;
+            mismatches += expect != ((alive >> k) & 1);
+          }
+        }
+        for (int v = 0; v < num_variants; v++) {
+          for (uint64_t B = 1; B <= 400; B += 32) {
+            uint32_t lanes[MAX_Z_FAMILY];
+            variants[v]->family_32(A, B, data, lanes);
+            for (int k = 0; k < 3; k++)
+              mismatches +=
+                  lanes[k] != variants[v]->survives_32(A, B, single[k]);
+          }
+        }
+      }
+      if (mismatches) {
+        printf("    FAIL: %" PRIu64 " z-family mismatches\n", mismatches);
+        errors++;
+      } else {
+        printf("    PASS: (3,4,{11,13,5}) survivors %" PRIu64 ", %" PRIu64
+               ", %" PRIu64 " match per-signature sieves\n",
+               survivors[0], survivors[1], survivors[2]);
+      }
+    }
+    for (int k = 0; k < 3; k++)
+      precompute_free(single[k]);
+  }
+  precompute_free(data);
+
+  /* Test 20: Tables mapped from the cache must equal freshly built ones */
+  printf("\n[20] Testing precompute cache...\n");
+
+  {
+    /* The cache directory itself does not exist yet: the first store
+     * creates it */
+    char root[] = "/tmp/hyper_goliath_cache_XXXXXX";
+    char cache_dir[sizeof(root) + 8];
+    PrecomputedData *built = NULL, *mapped = NULL;
+    bool ok = mkdtemp(root) != NULL;
+    snprintf(cache_dir, sizeof(cache_dir), "%s/cache", root);
+    for (int pass = 0; ok && pass < 2; pass++) {
+      data = precompute_create(3, 4, 13, 600, 600);
+      ok = data != NULL;
+      if (ok) {
+        data->cache_dir = cache_dir;
+        ok = precompute_build_wheel(data) && precompute_build_deep(data, 64);
+      }
+      if (pass == 0)
+        built = data;
+      else
+        mapped = data;
+    }
+
+    if (!ok) {
+      printf("    FAIL: Precomputation failed\n");
+      errors++;
+    } else {
+      const SieveWheel *w0 = &built->wheel, *w1 = &mapped->wheel;
+      uint32_t W = w0->modulus;
+      bool same = w1->modulus == W && w1->member_mask == w0->member_mask &&
+                  memcmp(w0->offsets, w1->offsets,
+                         (W + 1) * sizeof(uint32_t)) == 0 &&
+                  memcmp(w0->classes, w1->classes,
+                         w0->offsets[W] * sizeof(uint16_t)) == 0 &&
+                  mapped->deep.count == built->deep.count;
+      for (int i = 0; same && i < built->deep.count; i++) {
+        const DeepPrime *d0 = &built->deep.primes[i];
+        const DeepPrime *d1 = &mapped->deep.primes[i];
+        uint32_t p = d0->modulus;
+        same = d1->modulus == p &&
+               memcmp(d0->pow, d1->pow, 2 * p * sizeof(uint16_t)) == 0 &&
+               memcmp(d0->residue_mask, d1->residue_mask,
+                      (p + 63) / 64 * sizeof(uint64_t)) == 0;
+      }
+      bool was_mapped = mapped->wheel.map.base && mapped->deep.map.base &&
+                        !built->wheel.map.base && !built->deep.map.base;
+      if (!same || !was_mapped) {
+        printf("    FAIL: mapped=%d, identical=%d\n", was_mapped, same);
+        errors++;
+      } else {
+        printf("    PASS: W=%u wheel and %d-prime bank mapped from cache\n",
+               W, mapped->deep.count);
+      }
+    }
+    precompute_free(built);
+    precompute_free(mapped);
+
+    DIR *dir = ok ? opendir(cache_dir) : NULL;
+    for (struct dirent *e; dir && (e = readdir(dir));) {
+      char path[sizeof(cache_dir) + 256];
+      snprintf(path, sizeof(path), "%s/%s", cache_dir, e->d_name);
+      if (e->d_name[0] != '.')
+        unlink(path);
+    }
+    if (dir)
+      closedir(dir);
+    rmdir(cache_dir);
+    rmdir(root);
+  }
+
+  /* Test 21: A slice of a large range needs no more than a small range */
+  printf("\n[21] Testing window-aware precompute...\n");
+
+  {
+    PrecomputedData *full = precompute_create(3, 5, 7, 1000000, 300);
+    data = precompute_create_window(3, 5, 7, 999901, 1000000, 1, 300, NULL, 0);
+    PrecomputedData *small = precompute_create(3, 5, 7, 100, 300);
+    if (!full || !data || !small) {
+      printf("    FAIL: Precomputation failed\n");
+      errors++;
+    } else {
+      bool same = data->arena.size == small->arena.size &&
+                  data->arena.size == full->arena.size &&
+                  memcmp(data->arena.base, full->arena.base,
+                         data->arena.size) == 0;
+      uint64_t mismatches = 0;
+      uint64_t tile[300];
+      for (uint64_t A = data->A_start; A <= data->A_max; A += 64) {
+        sieve_sliced_tile(A, 1, 300, tile, data);
+        for (uint64_t B = 1; B <= 300; B++) {
+          for (uint64_t k = 0; k < 64; k++) {
+            bool expect = A + k <= data->A_max &&
+                          sieve_survives_scalar(A + k, B, full);
+            mismatches += expect != ((tile[B - 1] >> k) & 1);
+          }
+        }
+      }
+      if (!same || mismatches) {
+        printf("    FAIL: same tables=%d, %" PRIu64 " mismatches\n", same,
+               mismatches);
+        errors++;
+      } else {
+        printf("    PASS: A in [999901, 10^6] uses the %zu-byte tables of "
+               "A <= 100\n",
+               data->arena.size);
+      }
+    }
+    precompute_free(full);
+    precompute_free(small);
+  }
+  precompute_free(data);
+
+  /* Test 22: Coprimality bitmaps must agree with gcd64() bit for bit */
+  printf("\n[22] Testing factor table and coprimality bitmaps...\n");
+
+  data = precompute_create(3, 4, 5, 30030, 100);
+  if (!data || !precompute_build_factors(data)) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0, coprime = 0;
+    uint64_t bits[4];
+    /* Past the table's limit, rows fall back to trial division */
+    for (uint64_t A = 1; A <= 30030 + 2000; A++) {
+      uint64_t primes[MAX_DISTINCT_PRIMES], trial[MAX_DISTINCT_PRIMES];
+      int np = factor_distinct(A, &data->factors, primes);
+      int nt = factor_distinct(A, NULL, trial);
+      mismatches += np != nt ||
+                    memcmp(primes, trial, (size_t)np * sizeof(uint64_t)) != 0;
+
+      uint64_t B0 = 1 + A % 97;
+      coprime_bitmap(primes, np, B0, 4, bits);
+      for (uint64_t k = 0; k < 256; k++) {
+        bool expect = gcd64(A, B0 + k) == 1;
+        coprime += expect;
+        mismatches += expect != ((bits[k >> 6] >> (k & 63)) & 1);
+      }
+      mismatches += count_coprime_primes(primes, np, B0, B0 + 255) !=
+                    count_coprime_range(A, B0, B0 + 255);
+    }
+    if (mismatches || data->factors.limit != 30030) {
+      printf("    FAIL: %" PRIu64 " factor/bitmap mismatches\n", mismatches);
+      errors++;
+    } else {
+      printf("    PASS: %" PRIu64 " coprime pairs marked exactly\n", coprime);
+    }
+  }
+  precompute_free(data);
+
+  /* A window near the table's limit sieves only its own rows */
+  data = precompute_create_window(3, 4, 5, 16777000, 16777300, 1, 100, NULL,
+                                  0);
+  if (!data || !precompute_build_factors(data)) {
+    printf("    FAIL: Precomputation failed\n");
+    errors++;
+  } else {
+    uint64_t mismatches = 0;
+    for (uint64_t A = 16777000; A <= 16777300; A++) {
+      uint64_t primes[MAX_DISTINCT_PRIMES], trial[MAX_DISTINCT_PRIMES];
+      int np = factor_distinct(A, &data->factors, primes);
+      int nt = factor_distinct(A, NULL, trial);
+      mismatches += np != nt ||
+                    memcmp(primes, trial, (size_t)np * sizeof(uint64_t)) != 0;
+    }
+    if (mismatches || data->factors.base != 16777000 ||
+        data->factors.limit != FACTOR_TABLE_LIMIT ||
+        data->factors.arena.size > 4096) {
+      printf("    FAIL: %" PRIu64 " mismatches, %zu-byte table\n",
+             mismatches, data->factors.arena.size);
+      errors++;
+    } else {
+      printf("    PASS: Window [16777000, 16777300] factored from a %zu-byte "
+             "table\n",
+             data->factors.arena.size);
+    }
+  }
+  precompute_free(data);
+
+  /* Test 23: The reusable GMP context must agree without allocating */
+  printf("\n[23] Testing per-thread GMP verifier...\n");
+
+  {
+    GmpVerifier *gv = gmp_verifier_create(3, 3, 5, 400, 400);
+    uint64_t mismatches = 0, hits = 0;
+    void *(*old_alloc)(size_t);
+    void *(*old_realloc)(void *, size_t, size_t);
+    void (*old_free)(void *, size_t);
+    mp_get_memory_functions(&old_alloc, &old_realloc, &old_free);
+    mp_set_memory_functions(counting_alloc, counting_realloc, counting_free);
+    uint64_t allocations = 0;
+    for (uint64_t A = 1; gv && A <= 400; A++) {
+      for (uint64_t B = 1; B <= 400; B++) {
+        uint64_t C1 = 0, g1 = 0, C2 = 0, g2 = 0;
+        uint64_t before = gmp_allocations;
+        bool reused = gmp_verifier_check(gv, A, B, 1000000, &C1, &g1);
+        allocations += gmp_allocations - before;
+        bool fresh = check_beal_hit_gmp(A, B, 3, 3, 5, 1000000, &C2, &g2);
+        hits += fresh;
+        mismatches += reused != fresh || C1 != C2 || g1 != g2;
+      }
+    }
+    mp_set_memory_functions(old_alloc, old_realloc, old_free);
+
+    if (!gv || mismatches || hits == 0 || allocations) {
+      printf("    FAIL: %" PRIu64 " mismatches, %" PRIu64 " allocations\n",
+             mismatches, allocations);
+      errors++;
+    } else {
+      printf("    PASS: %" PRIu64 " hits agree, no allocations in 160000 "
+             "checks\n",
+             hits);
+    }
+    gmp_verifier_free(gv);
+  }
+
+  printf("\n[24] Testing fixed-width verifier against GMP...\n");
+
+  {
+    /* 128-bit sums, 256-bit sums, and sums past 2^256 */
+    static const struct {
+      uint32_t x, y, z;
+      uint64_t A0, A1, B1;
+    } cases[] = {
+        {3, 4, 5, 1, 300, 300},
+        {6, 7, 3, 1, 120, 120},
+        {3, 3, 5, 1, 400, 400},
+        {7, 7, 3, (1u << 20) - 40, 1u << 20, 150},
+        {40, 40, 3, 1, 120, 120},
+        {4, 4, 3, (1ull << 32) - 2, (1ull << 32) + 2, 40}, /* Near 2^128 */
+    };
+    uint64_t mismatches = 0, hits = 0, wide = 0, undecided = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+      uint32_t x = cases[i].x, y = cases[i].y, z = cases[i].z;
+      GmpVerifier *gv = gmp_verifier_create(x, y, z, cases[i].A1,
+                                            cases[i].B1);
+      if (!gv) {
+        mismatches++;
+        continue;
+      }
+      for (uint64_t A = cases[i].A0; A <= cases[i].A1; A++) {
+        for (uint64_t B = 1; B <= cases[i].B1; B++) {
+          uint64_t C1 = 0, g1 = 0, C2 = 0, g2 = 0, C3 = 0, g3 = 0;
+          bool decided;
+          bool fixed = check_beal_hit_fixed(A, B, x, y, z, UINT64_MAX, &C1,
+                                            &g1, &decided);
+          bool exact =
+              check_beal_hit_gmp(A, B, x, y, z, UINT64_MAX, &C2, &g2);
+          bool reused = gmp_verifier_check(gv, A, B, UINT64_MAX, &C3, &g3);
+          hits += exact;
+          wide += decided && i == 3; /* A^7 >= 2^139 */
+          undecided += !decided;
+          mismatches += reused != exact || C3 != C2 || g3 != g2;
+          if (decided)
+            mismatches += fixed != exact || C1 != C2 || g1 != g2;
+        }
+      }
+      gmp_verifier_free(gv);
+    }
+
+    /* Known hits, including 7^6 + 7^7 = 98^3 */
+    uint64_t C = 0, g = 0;
+    bool decided;
+    bool known = check_beal_hit_fixed(7, 7, 6, 7, 3, 1000, &C, &g,
+                                      &decided) &&
+                 C == 98 && g == 7 &&
+                 check_beal_hit_fixed(3, 6, 3, 3, 5, 1000, &C, &g,
+                                      &decided) &&
+                 C == 3 && g == 3 &&
+                 !check_beal_hit_fixed(7, 7, 6, 7, 3, 97, &C, &g, &decided);
+
+    if (mismatches || hits == 0 || wide == 0 || undecided == 0 || !known) {
+      printf("    FAIL: %" PRIu64 " mismatches, %" PRIu64 " hits, %" PRIu64
+             " 256-bit, %" PRIu64 " GMP fallbacks\n",
+             mismatches, hits, wide, undecided);
+      errors++;
+    } else {
+      printf("    PASS: %" PRIu64 " hits agree; %" PRIu64 " 256-bit sums, "
+             "%" PRIu64 " GMP fallbacks\n",
+             hits, wide, undecided);
+    }
+  }
+
   /* Summary */
   printf("\n=============================\n");
   if (errors == 0) {
@@ -205,10 +1156,19 @@ int main(int argc, char *argv[]) {
                          .C_max = 10000000,
                          .num_threads = 0,
                          .progress_interval = 0,
+                         .sieve_mode = SIEVE_MODE_LANES,
+                         .fused = false,
+                         .num_moduli = 0,
+                         .adaptive_moduli = 0,
+                         .reorder_rows = 0,
+                         .deep_primes = DEEP_BANK_DEFAULT,
+                         .euler_primes = EULER_FILTER_DEFAULT,
+                         .cache_dir = NULL,
                          .log_path = NULL};
 
   int do_validate = 0;
   char *log_path_buf = NULL;
+  bool log_path_given = false;
 
   /* Long options */
   static struct option long_options[] = {
@@ -223,6 +1183,14 @@ int main(int argc, char *argv[]) {
       {"threads", required_argument, 0, 't'},
       {"log", required_argument, 0, 'l'},
       {"progress", required_argument, 0, 'p'},
+      {"sieve", required_argument, 0, 's'},
+      {"fused", no_argument, 0, 'f'},
+      {"moduli", required_argument, 0, 'm'},
+      {"reorder", required_argument, 0, 'r'},
+      {"deep", required_argument, 0, 'd'},
+      {"euler", required_argument, 0, 'e'},
+      {"kernel", required_argument, 0, 'k'},
+      {"cache", required_argument, 0, 'c'},
       {"validate", no_argument, 0, 'v'},
       {"help", no_argument, 0, 'h'},
       {0, 0, 0, 0}};
@@ -230,7 +1198,8 @@ int main(int argc, char *argv[]) {
   int opt;
   int option_index = 0;
 
-  while ((opt = getopt_long(argc, argv, "x:y:z:A:B:C:a:b:t:l:p:vh",
+  while ((opt = getopt_long(argc, argv,
+                            "x:y:z:A:B:C:a:b:t:l:p:s:fm:r:d:e:k:c:vh",
                             long_options, &option_index)) != -1) {
     switch (opt) {
     case 'x':
@@ -240,7 +1209,11 @@ int main(int argc, char *argv[]) {
       params.y = atoi(optarg);
       break;
     case 'z':
-      params.z = atoi(optarg);
+      if (!parse_z_family(optarg, &params)) {
+        fprintf(stderr, "Error: Invalid z list '%s' (up to %d values)\n",
+                optarg, MAX_Z_FAMILY);
+        return 1;
+      }
       break;
     case 'A':
       params.A_max = strtoull(optarg, NULL, 10);
@@ -261,12 +1234,69 @@ int main(int argc, char *argv[]) {
       params.num_threads = atoi(optarg);
       break;
     case 'l':
+      log_path_given = true;
+      free(log_path_buf);
       log_path_buf = strdup(optarg);
       params.log_path = log_path_buf;
       break;
     case 'p':
       params.progress_interval = atoi(optarg);
       break;
+    case 's':
+      if (!sieve_mode_parse(optarg, &params.sieve_mode)) {
+        fprintf(stderr, "Error: Unknown sieve mode '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'f':
+      params.fused = true;
+      break;
+    case 'm':
+      if (strcmp(optarg, "adaptive") == 0 ||
+          strncmp(optarg, "adaptive:", 9) == 0) {
+        char *end = optarg + 8;
+        long count = *end == ':' ? strtol(end + 1, &end, 10)
+                                 : NUM_SIEVE_PRIMES;
+        if (*end != '\0' || count <= 0 || count > MAX_MODULI_LIST) {
+          fprintf(stderr, "Error: adaptive moduli count must be 1..%d\n",
+                  MAX_MODULI_LIST);
+          return 1;
+        }
+        params.adaptive_moduli = (int)count;
+        params.num_moduli = 0;
+      } else if (optarg[0] == '@') {
+        if (!parse_moduli_file(optarg + 1, &params))
+          return 1;
+        params.adaptive_moduli = 0;
+      } else if (sieve_moduli_parse(optarg, params.moduli,
+                                    &params.num_moduli)) {
+        params.adaptive_moduli = 0;
+      } else {
+        fprintf(stderr, "Error: Invalid moduli list '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'r':
+      params.reorder_rows = strtoull(optarg, NULL, 10);
+      break;
+    case 'd':
+      params.deep_primes = atoi(optarg);
+      break;
+    case 'e':
+      params.euler_primes = atoi(optarg);
+      if (params.euler_primes < 0 || params.euler_primes > MAX_EULER_PRIMES) {
+        fprintf(stderr, "Error: --euler must be in [0, %d]\n",
+                MAX_EULER_PRIMES);
+        return 1;
+      }
+      break;
+    case 'k':
+      if (!kernel_select(optarg))
+        return 1;
+      break;
+    case 'c':
+      params.cache_dir = optarg;
+      break;
     case 'v':
       do_validate = 1;
       break;
@@ -283,7 +1313,10 @@ int main(int argc, char *argv[]) {
   }
 
   /* Validate required parameters */
-  if (params.x < 3 || params.y < 3 || params.z < 3) {
+  bool low_z = false;
+  for (int k = 0; k < params.num_z; k++)
+    low_z |= params.z_family[k] < 3;
+  if (params.x < 3 || params.y < 3 || params.z < 3 || low_z) {
     fprintf(stderr, "Error: Exponents x, y, z must all be > 2\n");
     fprintf(stderr, "       (Beal Conjecture requires exponents >= 3)\n");
     print_usage(argv[0]);
@@ -300,6 +1333,12 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
+  if (params.num_z > 1 &&
+      (params.sieve_mode != SIEVE_MODE_LANES || params.fused)) {
+    fprintf(stderr, "Error: A z list needs --sieve lanes without --fused\n");
+    return 1;
+  }
+
   /* Generate default log path if not specified */
   if (!params.log_path) {
     log_path_buf = malloc(256);
@@ -308,18 +1347,46 @@ int main(int argc, char *argv[]) {
     params.log_path = log_path_buf;
   }
 
+  /* A z-family writes one log per signature: "<log>_z<Z>.jsonl", or
+   * "search_x_y_z_<time>.jsonl" by default */
+  char family_log_buf[MAX_Z_FAMILY][256];
+  for (int k = 0; params.num_z > 1 && k < params.num_z; k++) {
+    if (!log_path_given) {
+      snprintf(family_log_buf[k], 256, "search_%u_%u_%u_%lu.jsonl", params.x,
+               params.y, params.z_family[k], (unsigned long)time(NULL));
+    } else {
+      size_t stem = strlen(params.log_path);
+      if (stem > 6 && strcmp(params.log_path + stem - 6, ".jsonl") == 0)
+        stem -= 6;
+      snprintf(family_log_buf[k], 256, "%.*s_z%u.jsonl", (int)stem,
+               params.log_path, params.z_family[k]);
+    }
+    params.family_logs[k] = family_log_buf[k];
+  }
+
   /* Run the search */
-  SearchResults results;
-  search_parallel(&params, &results);
+  int num_sigs = params.num_z > 1 ? params.num_z : 1;
+  SearchResults results[MAX_Z_FAMILY];
+  search_parallel(&params, results);
 
   /* Print log location */
-  printf("\nLog file: %s\n", params.log_path);
+  if (params.num_z > 1) {
+    for (int k = 0; k < num_sigs; k++)
+      printf("%s%s", k ? ", " : "\nLog files: ", params.family_logs[k]);
+    printf("\n");
+  } else {
+    printf("\nLog file: %s\n", params.log_path);
+  }
 
   /* Cleanup */
-  results_free(&results);
+  uint64_t primitive_hits = 0;
+  for (int k = 0; k < num_sigs; k++) {
+    primitive_hits += results[k].primitive_hits;
+    results_free(&results[k]);
+  }
   if (log_path_buf)
     free(log_path_buf);
 
   /* Return 0 if no counterexamples, 42 if counterexample found */
-  return results.primitive_hits > 0 ? 42 : 0;
+  return primitive_hits > 0 ? 42 : 0;
 }
@@ -0,0 +1,55 @@
+/**
+ * Modular arithmetic setup: Montgomery constants and 64-bit primality.
+ * The per-operation primitives are inline in hyper_goliath.h.
+ */
+
+#include "hyper_goliath.h"
+
+/**
+ * Initialize Montgomery constants for q.
+ */
+bool mont64_init(Montgomery64 *mt, uint64_t q) {
+  if (!(q & 1) || q >> 63)
+    return false;
+
+  /* Newton iteration for q^-1 mod 2^64 (q odd) */
+  uint64_t inv = q;
+  for (int i = 0; i < 5; i++)
+    inv *= 2 - q * inv;
+
+  mt->q = q;
+  mt->q_neg_inv = (uint64_t)0 - inv;
+  mt->one = (uint64_t)(((uint128_t)1 << 64) % q);
+  mt->r2 = mulmod64(mt->one, mt->one, q);
+  return true;
+}
+
+/**
+ * Deterministic Miller-Rabin for 64-bit n (the first 12 prime bases suffice).
+ */
+bool is_prime64(uint64_t n) {
+  static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  if (n < 2)
+    return false;
+  for (int i = 0; i < 12; i++) {
+    if (n % bases[i] == 0)
+      return n == bases[i];
+  }
+
+  uint64_t d = n - 1;
+  int s = __builtin_ctzll(d);
+  d >>= s;
+  for (int i = 0; i < 12; i++) {
+    uint64_t x = powmod64(bases[i], d, n);
+    if (x == 1 || x == n - 1)
+      continue;
+    bool composite = true;
+    for (int r = 1; r < s && composite; r++) {
+      x = mulmod64(x, x, n);
+      composite = x != n - 1;
+    }
+    if (composite)
+      return false;
+  }
+  return true;
+}
@@ -15,6 +15,20 @@
 #include <omp.h>
 #endif
 
+/**
+ * Wall-clock seconds from an arbitrary origin. clock() would report CPU
+ * time, which grows with the number of threads filling the tables.
+ */
+static double wall_seconds(void) {
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
 /**
  * Initialize search results structure.
  */
@@ -51,11 +65,447 @@ void results_add_hit(SearchResults *results, const BealHit *hit) {
   results->hits[results->hits_count++] = *hit;
 }
 
+/**
+ * Per-thread buffer of hits, merged into the shared results in batches.
+ */
+typedef struct {
+  BealHit hits[64];
+  int count;
+} HitBuffer;
+
+/**
+ * Per-thread verification state for one signature: where its hits go, its
+ * deep bank, a thread-local copy of its Euler filter's Montgomery constants,
+ * its reusable GMP context and buffered hits.
+ */
+typedef struct {
+  const SearchParams *params; /* Signature, C_max and log path */
+  SearchResults *results;
+  const DeepBank *deep;
+  EulerFilter euler;
+  GmpVerifier *gmp; /* NULL: fall back to check_beal_hit_gmp() */
+  HitBuffer hits;
+} Verifier;
+
+/**
+ * Per-row (fixed A) counters, folded into the global atomics once per row.
+ */
+typedef struct {
+  uint64_t tested, gcd, mod, exact;
+  uint64_t deep;  /* Of exact: killed by the deep bank before GMP */
+  uint64_t euler; /* Of exact: killed by the Euler filter before GMP */
+} RowCounts;
+
+/**
+ * Merge a thread's buffered hits into the shared results and the log.
+ */
+static void hits_flush(Verifier *ver) {
+  HitBuffer *buf = &ver->hits;
+  if (buf->count == 0)
+    return;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+  {
+    for (int i = 0; i < buf->count; i++) {
+      results_add_hit(ver->results, &buf->hits[i]);
+      log_hit(ver->params->log_path, &buf->hits[i]);
+    }
+  }
+  buf->count = 0;
+}
+
+/**
+ * Exact GMP verification of a coprime sieve survivor, unless the deep bank
+ * or the Euler filter rules it out first.
+ */
+static void verify_survivor(uint64_t A, uint64_t B, Verifier *ver,
+                            RowCounts *row) {
+  const SearchParams *params = ver->params;
+  if (!sieve_deep_survives(A, B, ver->deep)) {
+    row->deep++;
+    return;
+  }
+  if (!euler_filter_passes(&ver->euler, A, B, params->x, params->y)) {
+    row->euler++;
+    return;
+  }
+
+  uint64_t C, g;
+  bool found =
+      ver->gmp ? gmp_verifier_check(ver->gmp, A, B, params->C_max, &C, &g)
+               : check_beal_hit_gmp(A, B, params->x, params->y, params->z,
+                                    params->C_max, &C, &g);
+  if (!found)
+    return;
+
+  BealHit hit = {A, B, C, g, params->x, params->y, params->z};
+  HitBuffer *buf = &ver->hits;
+  if (buf->count == 64) {
+    /* Critical dump if local hit buffer overflows */
+    hits_flush(ver);
+  }
+  buf->hits[buf->count++] = hit;
+
+  if (g == 1) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+    {
+      printf("\n🚨 COUNTEREXAMPLE: %" PRIu64 "^%u + %" PRIu64 "^%u = %" PRIu64
+             "^%u (gcd=1)\n",
+             A, params->x, B, params->y, C, params->z);
+    }
+  }
+}
+
+/**
+ * Close a sieve-first row of pairs pairs, coprime of them coprime to A, of
+ * which row->exact reached GMP. The gcd only ran on sieve survivors, so the
+ * other pairs are never classified individually; the counts still match the
+ * gcd-first order: gcd_filtered is exact from inclusion-exclusion over A's
+ * primes, and every other coprime pair was killed by the sieve.
+ */
+static void row_counts_close(RowCounts *row, uint64_t pairs,
+                             uint64_t coprime) {
+  row->tested = pairs;
+  row->gcd = pairs - coprime;
+  row->mod = coprime - row->exact;
+}
+
+/**
+ * Sweep one A row with the per-pair kernel: the selected variant's 32-lane
+ * kernel, or the signature-specialized kernel if given.
+ *
+ * The lane kernel runs sieve-first, with a gcd only on its survivors. The
+ * scalar specialized kernel costs more per pair than a bit test, so it runs
+ * only on the B that coprime_bitmap() marks coprime to A. Either way no gcd
+ * runs on the bulk of the pairs, and the counters match the gcd-first order.
+ */
+static void sweep_row_lanes(uint64_t A, const SearchParams *params,
+                            const PrecomputedData *data, const KernelSet *ks,
+                            SieveKernelFn kernel, Verifier *ver,
+                            uint64_t *cop, RowCounts *row) {
+  uint64_t B_start = params->B_start;
+  uint64_t B_max = params->B_max;
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, &data->factors, primes);
+
+  if (!kernel) {
+    for (uint64_t B = B_start; B <= B_max; B += 32) {
+      for (uint32_t s = ks->survives_32(A, B, data); s; s &= s - 1) {
+        uint64_t B_val = B + __builtin_ctz(s);
+        if (ks->gcd(A, B_val) > 1)
+          continue;
+        row->exact++;
+        verify_survivor(A, B_val, ver, row);
+      }
+    }
+    row_counts_close(row, B_max - B_start + 1,
+                     count_coprime_primes(primes, np, B_start, B_max));
+    return;
+  }
+
+  uint64_t coprime = 0;
+  for (uint64_t B0 = B_start; B0 <= B_max; B0 += SIEVE_ROW_BLOCK) {
+    uint64_t len = B_max - B0 + 1;
+    if (len > SIEVE_ROW_BLOCK)
+      len = SIEVE_ROW_BLOCK;
+    size_t nwords = (size_t)((len + 63) / 64);
+    coprime_bitmap(primes, np, B0, nwords, cop);
+    if (len & 63)
+      cop[nwords - 1] &= (1ULL << (len & 63)) - 1;
+
+    for (size_t w = 0; w < nwords; w++) {
+      coprime += (uint64_t)__builtin_popcountll(cop[w]);
+      for (uint64_t live = cop[w]; live; live &= live - 1) {
+        uint64_t B = B0 + 64 * w + __builtin_ctzll(live);
+        if (!kernel(A, B))
+          continue;
+        row->exact++;
+        verify_survivor(A, B, ver, row);
+      }
+    }
+  }
+  row_counts_close(row, B_max - B_start + 1, coprime);
+}
+
+/**
+ * Sweep one A row for every signature of a z-family at once.
+ *
+ * The sum residues are computed once per pair and tested against all of the
+ * family's residue sets; only pairs alive for some signature pay for a gcd,
+ * and each coprime one is verified once per signature it survives. rows[k]
+ * gets signature k's counts, closed as in row_counts_close().
+ */
+static void sweep_row_family(uint64_t A, const SearchParams *params,
+                             const PrecomputedData *data, const KernelSet *ks,
+                             Verifier *vers, RowCounts *rows) {
+  int num_sigs = data->family.count;
+  uint64_t B_start = params->B_start;
+  uint64_t B_max = params->B_max;
+
+  uint32_t survivors[MAX_Z_FAMILY];
+  for (uint64_t B = B_start; B <= B_max; B += 32) {
+    ks->family_32(A, B, data, survivors);
+    uint32_t any = 0;
+    for (int k = 0; k < num_sigs; k++)
+      any |= survivors[k];
+
+    for (; any; any &= any - 1) {
+      int lane = __builtin_ctz(any);
+      if (ks->gcd(A, B + lane) > 1)
+        continue;
+      for (int k = 0; k < num_sigs; k++) {
+        if (!((survivors[k] >> lane) & 1))
+          continue;
+        rows[k].exact++;
+        verify_survivor(A, B + lane, &vers[k], &rows[k]);
+      }
+    }
+  }
+
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, &data->factors, primes);
+  uint64_t coprime = count_coprime_primes(primes, np, B_start, B_max);
+  for (int k = 0; k < num_sigs; k++)
+    row_counts_close(&rows[k], B_max - B_start + 1, coprime);
+}
+
+/**
+ * Sweep one A row with the periodic-pattern bitmap kernel.
+ *
+ * The sieve bitmap is built per SIEVE_ROW_BLOCK values of B; only its set
+ * bits pay for a gcd, and the counters are closed as in row_counts_close().
+ */
+static void sweep_row_bitmap(uint64_t A, const SearchParams *params,
+                             const PrecomputedData *data, Verifier *ver,
+                             uint64_t *bits, RowCounts *row) {
+  uint64_t B_max = params->B_max;
+
+  for (uint64_t B0 = params->B_start; B0 <= B_max; B0 += SIEVE_ROW_BLOCK) {
+    uint64_t len = B_max - B0 + 1;
+    if (len > SIEVE_ROW_BLOCK)
+      len = SIEVE_ROW_BLOCK;
+    size_t nwords = (size_t)((len + 63) / 64);
+
+    sieve_row_bitmap(A, B0, nwords, bits, data);
+    if (len & 63)
+      bits[nwords - 1] &= (1ULL << (len & 63)) - 1;
+
+    for (size_t w = 0; w < nwords; w++) {
+      for (uint64_t live = bits[w]; live; live &= live - 1) {
+        uint64_t B = B0 + 64 * w + __builtin_ctzll(live);
+        if (gcd64(A, B) > 1)
+          continue;
+        row->exact++;
+        verify_survivor(A, B, ver, row);
+      }
+    }
+  }
+
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, &data->factors, primes);
+  row_counts_close(row, B_max - params->B_start + 1,
+                   count_coprime_primes(primes, np, params->B_start, B_max));
+}
+
+/**
+ * Sweep one A row with the two-tier sieve.
+ *
+ * Per block, a bitmap over the first SIEVE_TIER1_MODULI moduli is compacted
+ * into a dense list of B offsets, the remaining moduli filter that list, and
+ * only the final survivors pay for a gcd. Counters are closed as in
+ * row_counts_close().
+ */
+static void sweep_row_tiered(uint64_t A, const SearchParams *params,
+                             const PrecomputedData *data, Verifier *ver,
+                             uint64_t *bits, uint32_t *idx, RowCounts *row) {
+  uint64_t B_max = params->B_max;
+
+  for (uint64_t B0 = params->B_start; B0 <= B_max; B0 += SIEVE_ROW_BLOCK) {
+    uint64_t len = B_max - B0 + 1;
+    if (len > SIEVE_ROW_BLOCK)
+      len = SIEVE_ROW_BLOCK;
+    size_t nwords = (size_t)((len + 63) / 64);
+
+    sieve_row_prefix(A, B0, nwords, bits, data, SIEVE_TIER1_MODULI);
+    if (len & 63)
+      bits[nwords - 1] &= (1ULL << (len & 63)) - 1;
+
+    size_t n = sieve_compact_bits(bits, nwords, idx);
+    n = sieve_filter_compact(A, B0, idx, n, data, SIEVE_TIER1_MODULI);
+
+    for (size_t s = 0; s < n; s++) {
+      if (gcd64(A, B0 + idx[s]) > 1)
+        continue;
+      row->exact++;
+      verify_survivor(A, B0 + idx[s], ver, row);
+    }
+  }
+
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, &data->factors, primes);
+  row_counts_close(row, B_max - params->B_start + 1,
+                   count_coprime_primes(primes, np, params->B_start, B_max));
+}
+
+/**
+ * Filter a batch of wheel candidates (offsets from B_start) through the full
+ * sieve and verify the coprime survivors.
+ */
+static void wheel_flush(uint64_t A, const SearchParams *params,
+                        const PrecomputedData *data, Verifier *ver,
+                        uint32_t *idx, size_t n, RowCounts *row) {
+  n = sieve_filter_compact(A, params->B_start, idx, n, data, -1);
+  for (size_t s = 0; s < n; s++) {
+    uint64_t B = params->B_start + idx[s];
+    if (gcd64(A, B) > 1)
+      continue;
+    row->exact++;
+    verify_survivor(A, B, ver, row);
+  }
+}
+
+/**
+ * Sweep one A row through the residue-class wheel.
+ *
+ * Only B in the live classes of A mod W are generated (stepping by W within
+ * each class), batched into idx and filtered like the tiered sieve's second
+ * tier. Rows whose class has no live B class do no per-pair work at all.
+ * Counters are closed as in row_counts_close(): every skipped pair is
+ * either non-coprime or sieve-killed.
+ */
+static void sweep_row_wheel(uint64_t A, const SearchParams *params,
+                            const PrecomputedData *data, Verifier *ver,
+                            uint32_t *idx, RowCounts *row) {
+  const SieveWheel *wh = &data->wheel;
+  uint64_t B_start = params->B_start;
+  uint64_t B_max = params->B_max;
+  uint32_t W = wh->modulus;
+  uint32_t a = (uint32_t)(A % W);
+  uint32_t first = (uint32_t)(B_start % W);
+
+  size_t n = 0;
+  for (uint32_t c = wh->offsets[a]; c < wh->offsets[a + 1]; c++) {
+    /* Smallest B >= B_start with B = classes[c] (mod W) */
+    uint32_t k = (wh->classes[c] + W - first) % W;
+    for (uint64_t B = B_start + k; B <= B_max; B += W) {
+      idx[n++] = (uint32_t)(B - B_start);
+      if (n == SIEVE_ROW_BLOCK) {
+        wheel_flush(A, params, data, ver, idx, n, row);
+        n = 0;
+      }
+    }
+  }
+  wheel_flush(A, params, data, ver, idx, n, row);
+
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, &data->factors, primes);
+  row_counts_close(row, B_max - B_start + 1,
+                   count_coprime_primes(primes, np, B_start, B_max));
+}
+
+/**
+ * Sweep a tile of up to 64 A rows [A_lo, A_hi] with the bit-sliced kernel.
+ *
+ * Each SIEVE_ROW_BLOCK of B yields one survivor word per B; only the set bits
+ * pay for a gcd. Counters are closed as in row_counts_close(), summed over the
+ * tile's rows.
+ */
+static void sweep_tile_sliced(uint64_t A_lo, uint64_t A_hi,
+                              const SearchParams *params,
+                              const PrecomputedData *data, Verifier *ver,
+                              uint64_t *words, RowCounts *row) {
+  uint64_t B_max = params->B_max;
+  uint64_t rows = A_hi - A_lo + 1;
+  uint64_t rows_mask = rows >= 64 ? ~0ULL : (1ULL << rows) - 1;
+
+  for (uint64_t B0 = params->B_start; B0 <= B_max; B0 += SIEVE_ROW_BLOCK) {
+    uint64_t len = B_max - B0 + 1;
+    if (len > SIEVE_ROW_BLOCK)
+      len = SIEVE_ROW_BLOCK;
+
+    sieve_sliced_tile(A_lo, B0, (size_t)len, words, data);
+
+    for (uint64_t j = 0; j < len; j++) {
+      for (uint64_t live = words[j] & rows_mask; live; live &= live - 1) {
+        uint64_t A = A_lo + __builtin_ctzll(live);
+        if (gcd64(A, B0 + j) > 1)
+          continue;
+        row->exact++;
+        verify_survivor(A, B0 + j, ver, row);
+      }
+    }
+  }
+
+  uint64_t coprime = 0;
+  for (uint64_t A = A_lo; A <= A_hi; A++) {
+    uint64_t primes[MAX_DISTINCT_PRIMES];
+    int np = factor_distinct(A, &data->factors, primes);
+    coprime += count_coprime_primes(primes, np, params->B_start, B_max);
+  }
+  row_counts_close(row, rows * (B_max - params->B_start + 1), coprime);
+}
+
+/**
+ * Print the end-of-run summary for one signature.
+ */
+static void print_summary(const SearchResults *results) {
+  printf("Total pairs:     %" PRIu64 "\n", results->total_pairs);
+  printf("GCD filtered:    %" PRIu64 " (%.2f%%)\n", results->gcd_filtered,
+         100.0 * results->gcd_filtered / results->total_pairs);
+  printf("Sieve filtered:  %" PRIu64 " (%.2f%%)\n", results->mod_filtered,
+         100.0 * results->mod_filtered / results->total_pairs);
+  printf("Exact checks:    %" PRIu64 " (%.6f%%)\n", results->exact_checks,
+         100.0 * results->exact_checks /
+             (results->total_pairs ? results->total_pairs : 1));
+  printf("Deep filtered:   %" PRIu64 "\n", results->deep_filtered);
+  printf("Euler filtered:  %" PRIu64 " (GMP calls: %" PRIu64 ")\n",
+         results->euler_filtered,
+         results->exact_checks - results->deep_filtered -
+             results->euler_filtered);
+  printf("Power hits:      %" PRIu64 "\n", results->power_hits);
+  printf("Primitive hits:  %" PRIu64 "\n\n", results->primitive_hits);
+  printf("Runtime:         %.2f seconds\n", results->runtime_seconds);
+  printf("Throughput:      %.0f pairs/sec\n", results->rate_pairs_per_sec);
+
+  if (results->primitive_hits > 0) {
+    printf("\n*** COUNTEREXAMPLES FOUND! ***\n");
+    for (size_t i = 0; i < results->hits_count; i++) {
+      if (results->hits[i].gcd == 1) {
+        BealHit *h = &results->hits[i];
+        printf("  %" PRIu64 "^%u + %" PRIu64 "^%u = %" PRIu64 "^%u\n", h->A,
+               h->x, h->B, h->y, h->C, h->z);
+      }
+    }
+  } else {
+    printf("\nResult: CLEAR - No counterexamples found.\n");
+  }
+}
+
 /**
  * Main parallel search function.
  */
 void search_parallel(const SearchParams *params, SearchResults *results) {
-  results_init(results);
+  /* One signature per z of a z-family run, otherwise just params' own */
+  bool family = params->num_z > 1;
+  int num_sigs = family ? params->num_z : 1;
+  SearchParams sig[MAX_Z_FAMILY];
+  for (int k = 0; k < num_sigs; k++) {
+    sig[k] = *params;
+    if (family) {
+      sig[k].z = params->z_family[k];
+      sig[k].log_path = params->family_logs[k];
+    }
+    results_init(&results[k]);
+  }
+
+  if (family && (params->sieve_mode != SIEVE_MODE_LANES || params->fused)) {
+    fprintf(stderr, "ERROR: z-family runs need --sieve lanes without "
+                    "--fused\n");
+    return;
+  }
 
   /* Determine number of threads */
   int num_threads = params->num_threads;
@@ -70,261 +520,353 @@ void search_parallel(const SearchParams *params, SearchResults *results) {
 
   printf("Hyper-Goliath Search Engine\n");
   printf("===========================\n");
-  printf("Signature: (%u, %u, %u)\n", params->x, params->y, params->z);
+  printf("Signature%s:", family ? "s" : "");
+  for (int k = 0; k < num_sigs; k++)
+    printf(" (%u, %u, %u)", sig[k].x, sig[k].y, sig[k].z);
+  printf("\n");
   printf("Range: A[%" PRIu64 "-%" PRIu64 "] B[%" PRIu64 "-%" PRIu64
          "] C_max=%" PRIu64 "\n",
          params->A_start, params->A_max, params->B_start, params->B_max,
          params->C_max);
   printf("Threads: %d\n", num_threads);
+  printf("Kernels: %s\n", kernel_active()->name);
+  printf("Sieve: %s%s%s\n", sieve_mode_name(params->sieve_mode),
+         params->fused ? " (fused groups)" : "",
+         family ? " (z-family)" : "");
   printf("\n");
 
   /* Precompute residue data */
   printf("Precomputing residue tables...\n");
-  clock_t precompute_start = clock();
+  double precompute_start = wall_seconds();
+
+  const uint32_t *moduli = params->moduli;
+  int num_moduli = params->num_moduli;
+  uint32_t adaptive[MAX_MODULI_LIST];
+  if (params->adaptive_moduli > 0) {
+    num_moduli =
+        sieve_moduli_adaptive(params->z, params->adaptive_moduli, adaptive);
+    moduli = adaptive;
+    printf("Adaptive moduli:");
+    for (int i = 0; i < num_moduli; i++)
+      printf(" %u", adaptive[i]);
+    printf("\n");
+  }
 
-  PrecomputedData *data = precompute_create(params->x, params->y, params->z,
-                                            params->A_max, params->B_max);
+  PrecomputedData *data = precompute_create_window(
+      params->x, params->y, params->z, params->A_start, params->A_max,
+      params->B_start, params->B_max, moduli, num_moduli);
   if (!data) {
     fprintf(stderr, "ERROR: Precomputation failed\n");
     return;
   }
+  data->cache_dir = params->cache_dir;
 
-  double precompute_time =
-      (double)(clock() - precompute_start) / CLOCKS_PER_SEC;
-  printf("Precomputation complete (%.2f seconds)\n\n", precompute_time);
+  if (!precompute_build_factors(data)) {
+    fprintf(stderr, "ERROR: Factor table precomputation failed\n");
+    precompute_free(data);
+    return;
+  }
 
-  /* Log start */
-  uint64_t run_id = (uint64_t)time(NULL);
-  log_start(params->log_path, params, num_threads);
+  if (params->fused && !precompute_build_fused(data)) {
+    fprintf(stderr, "ERROR: Fused table precomputation failed\n");
+    precompute_free(data);
+    return;
+  }
+
+  if (family) {
+    if (!precompute_build_family(data, params->z_family, num_sigs,
+                                 params->deep_primes)) {
+      fprintf(stderr, "ERROR: z-family precomputation failed\n");
+      precompute_free(data);
+      return;
+    }
+    if (data->family.deep[0].count > 0)
+      printf("Deep banks: %d primes per signature\n",
+             data->family.deep[0].count);
+  } else if (params->deep_primes > 0) {
+    if (!precompute_build_deep(data, params->deep_primes)) {
+      fprintf(stderr, "ERROR: Deep bank precomputation failed\n");
+      precompute_free(data);
+      return;
+    }
+    if (data->deep.count > 0)
+      printf("Deep bank: %d primes (%u..%u)%s\n", data->deep.count,
+             data->deep.primes[0].modulus,
+             data->deep.primes[data->deep.count - 1].modulus,
+             data->deep.map.base ? " (cached)" : "");
+  }
+
+  EulerFilter euler[MAX_Z_FAMILY];
+  for (int k = 0; k < num_sigs; k++) {
+    if (!euler_filter_init(&euler[k], sig[k].z, params->euler_primes)) {
+      fprintf(stderr, "ERROR: Euler filter setup failed\n");
+      precompute_free(data);
+      return;
+    }
+    if (euler[k].count > 0)
+      printf("Euler filter: %d primes below 2^61 (q = 1 mod %u)\n",
+             euler[k].count, sig[k].z);
+  }
+
+  double precompute_time = wall_seconds() - precompute_start;
+  printf("Precomputation complete (%.2f seconds)\n\n", precompute_time);
 
   uint64_t A_start = params->A_start;
   uint64_t A_max = params->A_max;
-  uint64_t B_start = params->B_start;
-  uint64_t B_max = params->B_max;
-  uint64_t C_max = params->C_max;
 
-  uint64_t expected_pairs = (A_max - A_start + 1) * (B_max - B_start + 1);
+  /* Pick the per-signature test order from sampled kill rates */
+  SieveProfile profile;
+  sieve_profile_order(data, A_start, A_max, params->B_start, params->B_max,
+                      &profile);
+  if (family)
+    printf("Sieve order (z=%u):", data->z);
+  else
+    printf("Sieve order:");
+  for (int i = 0; i < profile.count; i++)
+    printf(" %u(%.1f%%)", profile.moduli[i], 100.0 * profile.kill_rate[i]);
+  printf("\n\n");
+
+  /* Bitmap kernels start each row from a shared prefix pattern */
+  if (params->sieve_mode == SIEVE_MODE_ROWS ||
+      params->sieve_mode == SIEVE_MODE_TIERED) {
+    if (!precompute_build_prefix(data, A_max - A_start + 1,
+                                 params->B_max - params->B_start + 1)) {
+      fprintf(stderr, "ERROR: Prefix cache precomputation failed\n");
+      precompute_free(data);
+      return;
+    }
+    if (data->prefix.period)
+      printf("Prefix cache: %d moduli, period %u, %u patterns\n\n",
+             data->prefix.num_members, data->prefix.period,
+             data->prefix.num_keys);
+  }
+
+  if (params->sieve_mode == SIEVE_MODE_WHEEL) {
+    if (!precompute_build_wheel(data)) {
+      fprintf(stderr, "ERROR: Wheel precomputation failed\n");
+      precompute_free(data);
+      return;
+    }
+    const SieveWheel *wh = &data->wheel;
+    uint32_t dead_rows = 0;
+    for (uint32_t a = 0; a < wh->modulus; a++)
+      dead_rows += wh->offsets[a] == wh->offsets[a + 1];
+    printf("Wheel: W=%u, %.2f%% of classes live, %u/%u A classes dead%s\n\n",
+           wh->modulus,
+           100.0 * wh->offsets[wh->modulus] /
+               ((double)wh->modulus * wh->modulus),
+           dead_rows, wh->modulus, wh->map.base ? " (cached)" : "");
+  }
+
+  /* Compiled-in kernel for the default moduli, if this signature has one.
+   * Baseline variant only: the SIMD lane kernels are faster still. */
+  const KernelSet *ks = kernel_active();
+  SieveKernelFn kernel = NULL;
+  if (ks->isa == KERNEL_ISA_BASELINE &&
+      params->sieve_mode == SIEVE_MODE_LANES && moduli == params->moduli &&
+      num_moduli == 0 && !params->fused && !family)
+    kernel = sieve_kernel_lookup(params->x, params->y, params->z);
+  if (kernel)
+    printf("Kernel: specialized (%u, %u, %u)\n\n", params->x, params->y,
+           params->z);
+
+  /* The bit-sliced kernel takes A in tiles of 64 rows */
+  uint64_t rows_per_step = params->sieve_mode == SIEVE_MODE_SLICED ? 64 : 1;
+
+  uint64_t epoch_rows =
+      params->reorder_rows > 0 ? params->reorder_rows : A_max - A_start + 1;
+
+  /* Log start; precompute time now also covers profiling, the prefix cache
+   * and the wheel */
+  uint64_t run_id = (uint64_t)time(NULL);
+  precompute_time = wall_seconds() - precompute_start;
+  for (int k = 0; k < num_sigs; k++) {
+    log_start(sig[k].log_path, &sig[k], data, num_threads, precompute_time);
+    /* The profile's kill rates are those of data->z's residue sets only */
+    if (sig[k].z == data->z)
+      log_sieve_order(sig[k].log_path, run_id, A_start, &profile);
+  }
+  uint64_t expected_pairs =
+      (A_max - A_start + 1) * (params->B_max - params->B_start + 1);
   printf("Starting search (%" PRIu64 " pairs)...\n", expected_pairs);
 
-/* Timing */
-#ifdef _OPENMP
-  double start_time = omp_get_wtime();
+  /* Timing */
+  double start_time = wall_seconds();
   double last_report_time = start_time;
-#else
-  clock_t start_time = clock();
-  double last_report_time = (double)start_time / CLOCKS_PER_SEC;
-#endif
 
-  /* Global counters for live UI. We use atomic to avoid reduction silos. */
+  /* Global counters for live UI. We use atomic to avoid reduction silos.
+   * tested and gcd skips are shared by a z-family; the rest are per z. */
   _Atomic uint64_t global_tested = 0;
   _Atomic uint64_t global_gcd_skips = 0;
-  _Atomic uint64_t global_mod_skips = 0;
-  _Atomic uint64_t global_exact_checks = 0;
+  _Atomic uint64_t global_mod_skips[MAX_Z_FAMILY];
+  _Atomic uint64_t global_exact_checks[MAX_Z_FAMILY];
+  _Atomic uint64_t global_deep_skips[MAX_Z_FAMILY];
+  _Atomic uint64_t global_euler_skips[MAX_Z_FAMILY];
+  for (int k = 0; k < num_sigs; k++) {
+    atomic_init(&global_mod_skips[k], 0);
+    atomic_init(&global_exact_checks[k], 0);
+    atomic_init(&global_deep_skips[k], 0);
+    atomic_init(&global_euler_skips[k], 0);
+  }
 
 /* Parallel search loop */
 #ifdef _OPENMP
 #pragma omp parallel
   {
 #endif
-    /* Thread-local hit buffer */
-    BealHit local_hits[64];
-    int local_hit_count = 0;
-
-#ifdef _OPENMP
-#pragma omp for schedule(dynamic, 1)
-#endif
-    for (uint64_t A = A_start; A <= A_max; A++) {
-      uint64_t a_tested = 0;
-      uint64_t a_gcd = 0;
-      uint64_t a_mod = 0;
-      uint64_t a_exact = 0;
-
-#ifdef HAVE_AVX2
-      for (uint64_t B = B_start; B <= B_max; B += 8) {
-        uint8_t survivors = sieve_survives_avx2_8(A, B, data);
-
-        for (int lane = 0; lane < 8 && B + lane <= B_max; lane++) {
-          uint64_t B_val = B + lane;
-          a_tested++;
-
-          if (gcd64(A, B_val) > 1) {
-            a_gcd++;
-            continue;
-          }
-
-          if (!(survivors & (1 << lane))) {
-            a_mod++;
-            continue;
-          }
-
-          a_exact++;
-          uint64_t C, g;
-          if (check_beal_hit_gmp(A, B_val, params->x, params->y, params->z,
-                                 C_max, &C, &g)) {
-            BealHit hit = {A, B_val, C, g, params->x, params->y, params->z};
-            if (local_hit_count < 64) {
-              local_hits[local_hit_count++] = hit;
-            } else {
-              /* Critical dump if local hit buffer overflows */
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-              {
-                for (int i = 0; i < local_hit_count; i++) {
-                  results_add_hit(results, &local_hits[i]);
-                  log_hit(params->log_path, &local_hits[i]);
-                }
-              }
-              local_hit_count = 0;
-              local_hits[local_hit_count++] = hit;
-            }
-
-            if (g == 1) {
+    /* Thread-local verifiers, one per signature */
+    Verifier ver[MAX_Z_FAMILY];
+    for (int k = 0; k < num_sigs; k++) {
+      ver[k].params = &sig[k];
+      ver[k].results = &results[k];
+      ver[k].deep = family ? &data->family.deep[k] : &data->deep;
+      ver[k].euler = euler[k];
+      ver[k].gmp = gmp_verifier_create(sig[k].x, sig[k].y, sig[k].z,
+                                       sig[k].A_max, sig[k].B_max);
+      ver[k].hits.count = 0;
+    }
+    uint64_t *row_bits = NULL;
+    uint64_t *row_cop = NULL;
+    uint32_t *row_idx = NULL;
+    if (params->sieve_mode == SIEVE_MODE_ROWS ||
+        params->sieve_mode == SIEVE_MODE_TIERED)
+      row_bits = (uint64_t *)malloc(SIEVE_ROW_WORDS * sizeof(uint64_t));
+    else if (params->sieve_mode == SIEVE_MODE_SLICED)
+      row_bits = (uint64_t *)malloc(SIEVE_ROW_BLOCK * sizeof(uint64_t));
+    if (kernel)
+      row_cop = (uint64_t *)malloc(SIEVE_ROW_WORDS * sizeof(uint64_t));
+    if (params->sieve_mode == SIEVE_MODE_TIERED ||
+        params->sieve_mode == SIEVE_MODE_WHEEL)
+      row_idx = (uint32_t *)malloc(SIEVE_ROW_BLOCK * sizeof(uint32_t));
+
+    /* Rows are swept in epochs; between epochs (all threads idle at the
+     * barrier) the test order may be re-profiled on the next epoch. */
+    for (uint64_t E = A_start; E <= A_max; E += epoch_rows) {
+      uint64_t E_end = A_max - E < epoch_rows ? A_max : E + epoch_rows - 1;
+
+      if (E != A_start) {
 #ifdef _OPENMP
-#pragma omp critical
+#pragma omp single
 #endif
-              {
-                printf("\n🚨 COUNTEREXAMPLE: %" PRIu64 "^%u + %" PRIu64
-                       "^%u = %" PRIu64 "^%u (gcd=1)\n",
-                       A, params->x, B_val, params->y, C, params->z);
-              }
-            }
+        {
+          SieveProfile refreshed;
+          sieve_profile_order(data, E, E_end, params->B_start, params->B_max,
+                              &refreshed);
+          for (int k = 0; k < num_sigs; k++) {
+            if (sig[k].z == data->z)
+              log_sieve_order(sig[k].log_path, run_id, E, &refreshed);
           }
         }
       }
-#else
-    for (uint64_t B = B_start; B <= B_max; B++) {
-      a_tested++;
-      if (gcd64(A, B) > 1) {
-        a_gcd++;
-        continue;
-      }
-      if (!sieve_survives_scalar(A, B, data)) {
-        a_mod++;
-        continue;
-      }
-      a_exact++;
-      uint64_t C, g;
-      if (check_beal_hit_gmp(A, B, params->x, params->y, params->z, C_max, &C,
-                             &g)) {
-        BealHit hit = {A, B, C, g, params->x, params->y, params->z};
-        if (local_hit_count < 64)
-          local_hits[local_hit_count++] = hit;
-        if (g == 1) {
-          printf("\n🚨 COUNTEREXAMPLE: %" PRIu64 "^%u + %" PRIu64
-                 "^%u = %" PRIu64 "^%u (gcd=1)\n",
-                 A, params->x, B, params->y, C, params->z);
-        }
-      }
-    }
-#endif
 
-      /* Update global stats atomically after each A iteration */
-      atomic_fetch_add(&global_tested, a_tested);
-      atomic_fetch_add(&global_gcd_skips, a_gcd);
-      atomic_fetch_add(&global_mod_skips, a_mod);
-      atomic_fetch_add(&global_exact_checks, a_exact);
-
-      /* Progress Report (Throttled to ~1.0s) */
 #ifdef _OPENMP
-      double now = omp_get_wtime();
-#else
-    double now = (double)clock() / CLOCKS_PER_SEC;
+#pragma omp for schedule(dynamic, 1)
 #endif
-      if (now - last_report_time > 1.0) {
+      for (uint64_t A = E; A <= E_end; A += rows_per_step) {
+        RowCounts row[MAX_Z_FAMILY];
+        memset(row, 0, (size_t)num_sigs * sizeof(RowCounts));
+
+        if (family)
+          sweep_row_family(A, params, data, ks, ver, row);
+        else if (params->sieve_mode == SIEVE_MODE_SLICED)
+          sweep_tile_sliced(A, E_end - A < 63 ? E_end : A + 63, params, data,
+                            ver, row_bits, row);
+        else if (params->sieve_mode == SIEVE_MODE_ROWS)
+          sweep_row_bitmap(A, params, data, ver, row_bits, row);
+        else if (params->sieve_mode == SIEVE_MODE_TIERED)
+          sweep_row_tiered(A, params, data, ver, row_bits, row_idx, row);
+        else if (params->sieve_mode == SIEVE_MODE_WHEEL)
+          sweep_row_wheel(A, params, data, ver, row_idx, row);
+        else
+          sweep_row_lanes(A, params, data, ks, kernel, ver, row_cop, row);
+
+        /* Update global stats atomically after each A iteration */
+        atomic_fetch_add(&global_tested, row[0].tested);
+        atomic_fetch_add(&global_gcd_skips, row[0].gcd);
+        for (int k = 0; k < num_sigs; k++) {
+          atomic_fetch_add(&global_mod_skips[k], row[k].mod);
+          atomic_fetch_add(&global_exact_checks[k], row[k].exact);
+          atomic_fetch_add(&global_deep_skips[k], row[k].deep);
+          atomic_fetch_add(&global_euler_skips[k], row[k].euler);
+        }
+
+        /* Progress Report (Throttled to ~1.0s) */
+        double now = wall_seconds();
+        if (now - last_report_time > 1.0) {
 #ifdef _OPENMP
 #pragma omp critical(report)
 #endif
-        {
-          if (now - last_report_time > 1.0) {
-            last_report_time = now;
-            double dt = now - start_time;
-            uint64_t tested = atomic_load(&global_tested);
-            double pct = 100.0 * tested / expected_pairs;
-            double rate = dt > 0 ? (double)tested / dt / 1e6 : 0;
-            uint64_t checks = atomic_load(&global_exact_checks);
-
-            printf("\r[GOLIATH] Progress: %5.2f%% | A: %-7" PRIu64
-                   " | Rate: %6.1fM/s | GMP Checks: %" PRIu64,
-                   pct, A, rate, checks);
-            fflush(stdout);
-
-            /* Log live checkpoint */
-            log_checkpoint(params->log_path, run_id, tested, expected_pairs,
-                           atomic_load(&global_gcd_skips),
-                           atomic_load(&global_mod_skips), dt,
-                           (int)(A - A_start), (int)(A_max - A_start));
+          {
+            if (now - last_report_time > 1.0) {
+              last_report_time = now;
+              double dt = now - start_time;
+              uint64_t tested = atomic_load(&global_tested);
+              double pct = 100.0 * tested / expected_pairs;
+              double rate = dt > 0 ? (double)tested / dt / 1e6 : 0;
+              uint64_t checks = 0;
+              for (int k = 0; k < num_sigs; k++)
+                checks += atomic_load(&global_exact_checks[k]) -
+                          atomic_load(&global_deep_skips[k]) -
+                          atomic_load(&global_euler_skips[k]);
+
+              printf("\r[GOLIATH] Progress: %5.2f%% | A: %-7" PRIu64
+                     " | Rate: %6.1fM/s | GMP Checks: %" PRIu64,
+                     pct, A, rate, checks);
+              fflush(stdout);
+
+              /* Log live checkpoint */
+              for (int k = 0; k < num_sigs; k++)
+                log_checkpoint(sig[k].log_path, run_id, tested,
+                               expected_pairs, atomic_load(&global_gcd_skips),
+                               atomic_load(&global_mod_skips[k]), dt,
+                               (int)(A - A_start), (int)(A_max - A_start));
+            }
           }
         }
       }
     }
 
     /* Thread finishing: Merge remaining hits */
-    if (local_hit_count > 0) {
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-      {
-        for (int i = 0; i < local_hit_count; i++) {
-          results_add_hit(results, &local_hits[i]);
-          log_hit(params->log_path, &local_hits[i]);
-        }
-      }
+    for (int k = 0; k < num_sigs; k++) {
+      hits_flush(&ver[k]);
+      gmp_verifier_free(ver[k].gmp);
     }
+    free(row_bits);
+    free(row_cop);
+    free(row_idx);
 
 #ifdef _OPENMP
   }
 #endif
 
-/* Calculate final timing */
-#ifdef _OPENMP
-  double elapsed = omp_get_wtime() - start_time;
-#else
-  double elapsed = (double)(clock() - start_time) / CLOCKS_PER_SEC;
-#endif
-
-  results->total_pairs = atomic_load(&global_tested);
-  results->gcd_filtered = atomic_load(&global_gcd_skips);
-  results->mod_filtered = atomic_load(&global_mod_skips);
-  results->exact_checks = atomic_load(&global_exact_checks);
-  results->runtime_seconds = elapsed;
-  results->rate_pairs_per_sec =
-      elapsed > 0 ? results->total_pairs / elapsed : 0;
-
-  results->power_hits = results->hits_count;
-  results->primitive_hits = 0;
-  for (size_t i = 0; i < results->hits_count; i++) {
-    if (results->hits[i].gcd == 1)
-      results->primitive_hits++;
-  }
-
-  log_complete(params->log_path, run_id, params, results);
+  /* Calculate final timing */
+  double elapsed = wall_seconds() - start_time;
 
   printf("\n\nSearch Complete!\n================\n");
-  printf("Total pairs:     %" PRIu64 "\n", results->total_pairs);
-  printf("GCD filtered:    %" PRIu64 " (%.2f%%)\n", results->gcd_filtered,
-         100.0 * results->gcd_filtered / results->total_pairs);
-  printf("Sieve filtered:  %" PRIu64 " (%.2f%%)\n", results->mod_filtered,
-         100.0 * results->mod_filtered / results->total_pairs);
-  printf("Exact checks:    %" PRIu64 " (%.6f%%)\n", results->exact_checks,
-         100.0 * results->exact_checks /
-             (results->total_pairs ? results->total_pairs : 1));
-  printf("Power hits:      %" PRIu64 "\n", results->power_hits);
-  printf("Primitive hits:  %" PRIu64 "\n\n", results->primitive_hits);
-  printf("Runtime:         %.2f seconds\n", results->runtime_seconds);
-  printf("Throughput:      %.0f pairs/sec\n", results->rate_pairs_per_sec);
-
-  if (results->primitive_hits > 0) {
-    printf("\n*** COUNTEREXAMPLES FOUND! ***\n");
-    for (size_t i = 0; i < results->hits_count; i++) {
-      if (results->hits[i].gcd == 1) {
-        BealHit *h = &results->hits[i];
-        printf("  %" PRIu64 "^%u + %" PRIu64 "^%u = %" PRIu64 "^%u\n", h->A,
-               h->x, h->B, h->y, h->C, h->z);
-      }
+  for (int k = 0; k < num_sigs; k++) {
+    SearchResults *res = &results[k];
+    res->total_pairs = atomic_load(&global_tested);
+    res->gcd_filtered = atomic_load(&global_gcd_skips);
+    res->mod_filtered = atomic_load(&global_mod_skips[k]);
+    res->exact_checks = atomic_load(&global_exact_checks[k]);
+    res->deep_filtered = atomic_load(&global_deep_skips[k]);
+    res->euler_filtered = atomic_load(&global_euler_skips[k]);
+    res->runtime_seconds = elapsed;
+    res->rate_pairs_per_sec = elapsed > 0 ? res->total_pairs / elapsed : 0;
+
+    res->power_hits = res->hits_count;
+    res->primitive_hits = 0;
+    for (size_t i = 0; i < res->hits_count; i++) {
+      if (res->hits[i].gcd == 1)
+        res->primitive_hits++;
     }
-  } else {
-    printf("\nResult: CLEAR - No counterexamples found.\n");
+
+    log_complete(sig[k].log_path, run_id, &sig[k], res);
+
+    if (family)
+      printf("%s(%u, %u, %u)\n", k ? "\n" : "", sig[k].x, sig[k].y,
+             sig[k].z);
+    print_summary(res);
   }
 
   precompute_free(data);
@@ -6,26 +6,362 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+
+/* Arenas of at least this size are placed on transparent huge pages */
+#define ARENA_HUGE_PAGE ((size_t)2 << 20)
+
+/* Table alignment within an arena: one cache line */
+#define ARENA_ALIGN 64
 
 /**
- * Compute the z-th power residue set for a prime p.
+ * Compute the z-th power residue set modulo m (m <= 128).
+ *
+ * m need not be prime: {r^z mod m | r in [0, m)} is exactly the set of
+ * residues a perfect z-th power can take, so prime powers work unchanged.
  */
-void compute_residue_mask128(uint32_t p, uint32_t z, uint64_t mask[2]) {
+void compute_residue_mask128(uint32_t m, uint32_t z, uint64_t mask[2]) {
+  uint8_t rz[MAX_SIEVE_MODULUS];
+  kernel_active()->pow_table8(rz, m, z, m);
+
   mask[0] = 0;
   mask[1] = 0;
+  for (uint32_t r = 0; r < m; r++)
+    set_bit128(mask, rz[r]);
+}
+
+/**
+ * Set bit r^z mod m of mask for every r < m (m <= 2^16).
+ */
+static bool fill_residue_mask(uint64_t *mask, uint32_t m, uint32_t z) {
+  uint16_t *rz = (uint16_t *)malloc(m * sizeof(uint16_t));
+  if (!rz)
+    return false;
+  kernel_active()->pow_table16(rz, m, z, m);
+  for (uint32_t r = 0; r < m; r++)
+    mask[rz[r] >> 6] |= 1ULL << (rz[r] & 63);
+  free(rz);
+  return true;
+}
 
-  for (uint32_t r = 0; r < p; r++) {
-    uint64_t rz = powmod(r, z, p);
-    set_bit128(mask, (uint32_t)rz);
+/**
+ * Map a zeroed arena of at least size bytes. No page is touched here, so
+ * each one is faulted in on the NUMA node of the thread that first writes
+ * it. Arenas of a huge page or more are aligned to one and advised onto
+ * transparent huge pages.
+ */
+static bool arena_alloc(TableArena *arena, size_t size) {
+  memset(arena, 0, sizeof(*arena));
+  bool huge = size >= ARENA_HUGE_PAGE;
+  if (huge)
+    size = (size + ARENA_HUGE_PAGE - 1) & ~(ARENA_HUGE_PAGE - 1);
+  size_t span = huge ? size + ARENA_HUGE_PAGE : (size ? size : 1);
+
+  uint8_t *map = (uint8_t *)mmap(NULL, span, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "ERROR: Failed to map a %zu-byte table arena\n", span);
+    return false;
+  }
+  if (!huge) {
+    arena->base = map;
+    arena->size = span;
+    return true;
   }
+
+  /* Trim the mapping to a huge-page-aligned window */
+  uint8_t *base = (uint8_t *)(((uintptr_t)map + ARENA_HUGE_PAGE - 1) &
+                              ~(uintptr_t)(ARENA_HUGE_PAGE - 1));
+  if (base > map)
+    munmap(map, (size_t)(base - map));
+  if (map + span > base + size)
+    munmap(base + size, (size_t)(map + span - (base + size)));
+  arena->base = base;
+  arena->size = size;
+#ifdef MADV_HUGEPAGE
+  arena->huge = madvise(base, size, MADV_HUGEPAGE) == 0;
+#endif
+  return true;
+}
+
+/**
+ * Unmap an arena.
+ */
+static void arena_free(TableArena *arena) {
+  if (arena->base)
+    munmap(arena->base, arena->size);
+  memset(arena, 0, sizeof(*arena));
+}
+
+/**
+ * Reserve bytes at the next align-byte boundary after *at; returns the slot
+ * in base, or NULL when only sizing (base == NULL).
+ */
+static void *arena_slot(uint8_t *base, size_t *at, size_t bytes,
+                        size_t align) {
+  size_t offset = (*at + align - 1) & ~(align - 1);
+  *at = offset + bytes;
+  return base ? base + offset : NULL;
 }
 
 /**
- * Create and populate precomputed data for a signature.
+ * The "powers" moduli preset: the 20 sieve primes with 2, 3, 5, 7 and 11
+ * raised to their largest power <= MAX_SIEVE_MODULUS. Residues modulo p^k
+ * determine residues modulo p, so each prime power kills at least every pair
+ * its prime does.
+ */
+static const uint8_t SIEVE_PRIME_POWERS[NUM_SIEVE_PRIMES] = {
+    128, 81, 125, 49, 121, 13, 17, 19, 23, 29,
+    31,  37, 41,  43, 47,  53, 59, 61, 67, 71};
+
+/**
+ * Parse a moduli specification.
+ */
+bool sieve_moduli_parse(const char *spec, uint32_t *moduli, int *count) {
+  if (strcmp(spec, "primes") == 0 || strcmp(spec, "powers") == 0) {
+    const uint8_t *src =
+        strcmp(spec, "primes") == 0 ? SIEVE_PRIMES : SIEVE_PRIME_POWERS;
+    for (int i = 0; i < NUM_SIEVE_PRIMES; i++)
+      moduli[i] = src[i];
+    *count = NUM_SIEVE_PRIMES;
+    return true;
+  }
+
+  int n = 0;
+  const char *cur = spec;
+  while (*cur) {
+    char *end;
+    unsigned long m = strtoul(cur, &end, 10);
+    if (end == cur || m < 2 || m > MAX_WIDE_MODULUS || n == MAX_MODULI_LIST)
+      return false;
+    for (int i = 0; i < n; i++) {
+      if (moduli[i] == m)
+        return false;
+    }
+    moduli[n++] = (uint32_t)m;
+    if (*end == ',')
+      end++;
+    else if (*end)
+      return false;
+    cur = end;
+  }
+
+  *count = n;
+  return n > 0;
+}
+
+/**
+ * Does prime p divide one of data's sieve moduli (byte or wide tier)?
+ */
+static bool divides_sieve_modulus(uint32_t p, const PrecomputedData *data) {
+  for (int i = 0; i < data->num_moduli; i++) {
+    if (data->moduli[i] % p == 0)
+      return true;
+  }
+  for (int w = 0; w < data->num_wide; w++) {
+    if (data->wide[w].modulus % p == 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Rank the primes below 2^16 for z-th power filtering.
+ *
+ * The primes that filter z-th powers best are those with p = 1 (mod z),
+ * where the nonzero z-th powers form a subgroup of index g = gcd(z, p-1) and
+ * the residue density is (1 + (p-1)/g) / p, about 1/g. Primes are ranked by
+ * g (largest first); within the same g the density differs only by the O(1/p)
+ * share of the zero residue, so the smaller prime wins for its smaller,
+ * cache-resident tables. Primes with g = 1 never kill anything. Primes
+ * dividing a modulus of exclude (if given) are skipped. Writes up to k primes
+ * best first and returns how many.
+ */
+static int rank_primes(uint32_t z, int k, const PrecomputedData *exclude,
+                       uint32_t *out) {
+  uint8_t *composite = (uint8_t *)calloc(MAX_WIDE_MODULUS + 1, 1);
+  uint32_t *best_index = (uint32_t *)malloc((size_t)k * sizeof(uint32_t));
+  if (!composite || !best_index || k <= 0) {
+    free(composite);
+    free(best_index);
+    return 0;
+  }
+
+  /* Keep the k best (index, prime) so far in a sorted array; primes arrive
+   * in increasing order, so ties already favour the smaller one. */
+  int n = 0;
+  for (uint32_t p = 2; p <= MAX_WIDE_MODULUS; p++) {
+    if (composite[p])
+      continue;
+    for (uint32_t q = p * p; q <= MAX_WIDE_MODULUS; q += p)
+      composite[q] = 1;
+
+    uint32_t g = (uint32_t)gcd64(z, p - 1);
+    if (g == 1 || (exclude && divides_sieve_modulus(p, exclude)))
+      continue;
+
+    if (n == k && g <= best_index[n - 1])
+      continue;
+    int pos = n < k ? n++ : n - 1;
+    while (pos > 0 && best_index[pos - 1] < g) {
+      best_index[pos] = best_index[pos - 1];
+      out[pos] = out[pos - 1];
+      pos--;
+    }
+    best_index[pos] = g;
+    out[pos] = p;
+  }
+  free(composite);
+  free(best_index);
+  return n;
+}
+
+/**
+ * Signature-adaptive moduli selection (see rank_primes()).
+ */
+int sieve_moduli_adaptive(uint32_t z, int k, uint32_t *moduli) {
+  if (k > MAX_MODULI_LIST)
+    k = MAX_MODULI_LIST;
+  int n = rank_primes(z, k, NULL, moduli);
+
+  /* Ascending by value so the byte tier comes first */
+  for (int i = 1; i < n; i++) {
+    uint32_t v = moduli[i];
+    int j = i;
+    while (j > 0 && moduli[j - 1] > v) {
+      moduli[j] = moduli[j - 1];
+      j--;
+    }
+    moduli[j] = v;
+  }
+  return n;
+}
+
+/**
+ * Base primes of the groups fused by precompute_build_fused() (0-terminated).
+ * With the default primes the products are 210, 143 and 323, so all tables
+ * fit in L1. A sieve modulus joins a group when all of its prime factors are
+ * in the group; the group modulus is the lcm of its members.
+ */
+static const uint32_t FUSED_GROUP_PRIMES[][5] = {
+    {2, 3, 5, 7, 0}, /* 2*3*5*7 = 210 */
+    {11, 13, 0},     /* 11*13 = 143 */
+    {17, 19, 0},     /* 17*19 = 323 */
+};
+#define NUM_DEFAULT_FUSED                                                      \
+  ((int)(sizeof(FUSED_GROUP_PRIMES) / sizeof(FUSED_GROUP_PRIMES[0])))
+
+/* Groups whose lcm exceeds this are left as individual moduli. */
+#define MAX_FUSED_MODULUS 512
+
+/**
+ * Assign the arena slots of the per-modulus tables, in base (or just size
+ * them when base is NULL). Returns the bytes used.
+ */
+static size_t layout_tables(PrecomputedData *data, uint8_t *base) {
+  size_t at = 0;
+  for (int i = 0; i < data->num_moduli; i++) {
+    size_t p = data->moduli[i];
+    size_t pattern_bytes = p * PATTERN_WORDS * sizeof(uint64_t);
+    data->by_pow[i] =
+        (uint8_t *)arena_slot(base, &at, p + SIEVE_LANE_PAD, ARENA_ALIGN);
+    data->b_patterns[i] =
+        (uint64_t *)arena_slot(base, &at, pattern_bytes, ARENA_ALIGN);
+    data->a_patterns[i] =
+        (uint64_t *)arena_slot(base, &at, pattern_bytes, ARENA_ALIGN);
+  }
+  for (int w = 0; w < data->num_wide; w++) {
+    WideModulus *wm = &data->wide[w];
+    size_t m = wm->modulus;
+    wm->mask_words = (uint32_t)((m + 63) / 64);
+    wm->residue_mask = (uint64_t *)arena_slot(
+        base, &at, wm->mask_words * sizeof(uint64_t), ARENA_ALIGN);
+    wm->pow = (uint16_t *)arena_slot(base, &at, 2 * m * sizeof(uint16_t),
+                                     ARENA_ALIGN);
+  }
+  return at;
+}
+
+/**
+ * Fill the residue mask, power tables and survivor patterns of byte-tier
+ * modulus i. Patterns are over B for the row-bitmap sieve and over A
+ * (transposed) for the bit-sliced sieve.
+ */
+static void fill_modulus(PrecomputedData *data, const KernelSet *ks, int i) {
+  uint32_t p = data->moduli[i];
+  compute_residue_mask128(p, data->z, data->residue_masks[i]);
+
+  /* Residue-indexed power tables: O(m) per modulus, whatever the range */
+  data->reduce[i] = barrett64_init(p);
+  ks->pow_table8(data->ax_pow[i], p, data->x, p);
+  ks->pow_table8(data->by_pow[i], p + SIEVE_LANE_PAD, data->y, p);
+
+  for (uint32_t a = 0; a < p; a++) {
+    uint64_t *pat = data->b_patterns[i] + (size_t)a * PATTERN_WORDS;
+    for (uint32_t k = 0; k < PATTERN_WORDS * 64; k++) {
+      uint32_t sum = (a + data->by_pow[i][k % p]) % p;
+      if (get_bit128(data->residue_masks[i], sum))
+        pat[k >> 6] |= 1ULL << (k & 63);
+    }
+  }
+
+  for (uint32_t v = 0; v < p; v++) {
+    uint64_t *pat = data->a_patterns[i] + (size_t)v * PATTERN_WORDS;
+    for (uint32_t k = 0; k < PATTERN_WORDS * 64; k++) {
+      uint32_t sum = (data->ax_pow[i][k % p] + v) % p;
+      if (get_bit128(data->residue_masks[i], sum))
+        pat[k >> 6] |= 1ULL << (k & 63);
+    }
+  }
+}
+
+/**
+ * Fill the variable-width mask and 16-bit power tables of wide modulus w.
+ */
+static bool fill_wide(PrecomputedData *data, const KernelSet *ks, int w) {
+  WideModulus *wm = &data->wide[w];
+  uint32_t m = wm->modulus;
+  if (!fill_residue_mask(wm->residue_mask, m, data->z))
+    return false;
+  wm->reduce = barrett64_init(m);
+  ks->pow_table16(wm->pow, m, data->x, m);
+  ks->pow_table16(wm->pow + m, m, data->y, m);
+  return true;
+}
+
+/**
+ * Create and populate precomputed data for a signature (default primes).
  */
 PrecomputedData *precompute_create(uint32_t x, uint32_t y, uint32_t z,
                                    uint64_t A_max, uint64_t B_max) {
-  PrecomputedData *data = (PrecomputedData *)malloc(sizeof(PrecomputedData));
+  return precompute_create_moduli(x, y, z, A_max, B_max, NULL, 0);
+}
+
+/**
+ * Create and populate precomputed data for a signature, searching from 1.
+ */
+PrecomputedData *precompute_create_moduli(uint32_t x, uint32_t y, uint32_t z,
+                                          uint64_t A_max, uint64_t B_max,
+                                          const uint32_t *moduli,
+                                          int num_moduli) {
+  return precompute_create_window(x, y, z, 1, A_max, 1, B_max, moduli,
+                                  num_moduli);
+}
+
+/**
+ * Create and populate precomputed data for a search window.
+ */
+PrecomputedData *precompute_create_window(uint32_t x, uint32_t y, uint32_t z,
+                                          uint64_t A_start, uint64_t A_max,
+                                          uint64_t B_start, uint64_t B_max,
+                                          const uint32_t *moduli,
+                                          int num_moduli) {
+  if (A_start < 1 || B_start < 1 || A_max < A_start || B_max < B_start) {
+    fprintf(stderr, "ERROR: Empty search window\n");
+    return NULL;
+  }
+
+  PrecomputedData *data = (PrecomputedData *)calloc(1, sizeof(PrecomputedData));
   if (!data) {
     fprintf(stderr, "ERROR: Failed to allocate PrecomputedData\n");
     return NULL;
@@ -34,67 +370,695 @@ PrecomputedData *precompute_create(uint32_t x, uint32_t y, uint32_t z,
   data->x = x;
   data->y = y;
   data->z = z;
+  data->A_start = A_start;
   data->A_max = A_max;
+  data->B_start = B_start;
   data->B_max = B_max;
 
-  /* Compute residue masks for each prime */
-  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-    uint32_t p = SIEVE_PRIMES[i];
-    compute_residue_mask128(p, z, data->residue_masks[i]);
+  if (num_moduli <= 0) {
+    data->num_moduli = NUM_SIEVE_PRIMES;
+    for (int i = 0; i < NUM_SIEVE_PRIMES; i++)
+      data->moduli[i] = SIEVE_PRIMES[i];
+  } else {
+    /* Split into the byte tier and the wide tier */
+    for (int i = 0; i < num_moduli; i++) {
+      bool wide = moduli[i] > MAX_SIEVE_MODULUS;
+      if (!wide && data->num_moduli < MAX_SIEVE_MODULI) {
+        data->moduli[data->num_moduli++] = moduli[i];
+      } else if (wide && data->num_wide < MAX_WIDE_MODULI) {
+        data->wide[data->num_wide++].modulus = moduli[i];
+      } else {
+        fprintf(stderr, "ERROR: Too many sieve moduli\n");
+        free(data);
+        return NULL;
+      }
+    }
   }
+  int nm = data->num_moduli;
+
+  for (int i = 0; i < nm; i++)
+    data->order[i] = (uint8_t)i;
+  for (int w = 0; w < data->num_wide; w++)
+    data->wide_order[w] = (uint8_t)w;
 
-  /* Allocate and compute ax_mod (A-major) */
-  data->ax_mod = (uint8_t **)malloc((A_max + 1) * sizeof(uint8_t *));
-  if (!data->ax_mod) {
+  /* One cache-line-aligned arena for every per-modulus table, filled one
+   * modulus per task so each thread first-touches the tables it builds */
+  size_t bytes = layout_tables(data, NULL);
+  if (!arena_alloc(&data->arena, bytes)) {
     free(data);
     return NULL;
   }
+  layout_tables(data, (uint8_t *)data->arena.base);
 
-  for (uint64_t A = 0; A <= A_max; A++) {
-    data->ax_mod[A] = (uint8_t *)malloc(NUM_SIEVE_PRIMES * sizeof(uint8_t));
-    for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-      data->ax_mod[A][i] = (uint8_t)powmod(A, x, SIEVE_PRIMES[i]);
+  const KernelSet *ks = kernel_active();
+  int tasks = nm + data->num_wide;
+  bool ok = true;
+#pragma omp parallel for schedule(dynamic, 1) reduction(&& : ok)
+  for (int t = 0; t < tasks; t++) {
+    if (t < nm)
+      fill_modulus(data, ks, t);
+    else
+      ok = fill_wide(data, ks, t - nm) && ok;
+  }
+  if (!ok) {
+    precompute_free(data);
+    return NULL;
+  }
+
+  return data;
+}
+
+/**
+ * Release the fused group tables and leave data without fused groups.
+ */
+static void free_fused(PrecomputedData *data) {
+  for (int g = 0; g < data->num_fused; g++) {
+    free(data->fused[g].rows);
+  }
+  memset(data->fused, 0, sizeof(data->fused));
+  data->num_fused = 0;
+  data->fused_mask = 0;
+}
+
+/**
+ * Build the CRT-fused pair tables.
+ */
+bool precompute_build_fused(PrecomputedData *data) {
+  for (int spec = 0; spec < NUM_DEFAULT_FUSED; spec++) {
+    const uint32_t *base = FUSED_GROUP_PRIMES[spec];
+
+    /* Collect the sieve moduli whose prime factors all lie in the group */
+    uint32_t members = 0;
+    uint64_t M = 1;
+    int count = 0;
+    for (int i = 0; i < data->num_moduli; i++) {
+      uint32_t rest = data->moduli[i];
+      for (int k = 0; base[k]; k++) {
+        while (rest % base[k] == 0)
+          rest /= base[k];
+      }
+      if (rest != 1)
+        continue;
+      members |= 1u << i;
+      M = M / gcd64(M, data->moduli[i]) * data->moduli[i];
+      count++;
     }
+    if (count < 2 || M > MAX_FUSED_MODULUS)
+      continue;
+
+    FusedGroup *grp = &data->fused[data->num_fused++];
+    grp->modulus = (uint32_t)M;
+    grp->member_mask = members;
+    grp->row_words = (grp->modulus + 64 + 63) / 64 + 1;
+    grp->rows = (uint64_t *)calloc(M * grp->row_words, sizeof(uint64_t));
+    grp->reduce = barrett64_init((uint32_t)M);
+    if (!grp->rows) {
+      free_fused(data);
+      return false;
+    }
+
+    /* Row a, bit k: (a, k mod M) survives every member modulus */
+    for (uint32_t a = 0; a < M; a++) {
+      uint64_t *row = grp->rows + (size_t)a * grp->row_words;
+      for (uint32_t k = 0; k < M + 64; k++) {
+        uint32_t b = k % M;
+        bool alive = true;
+        for (int i = 0; i < data->num_moduli && alive; i++) {
+          if (!(members & (1u << i)))
+            continue;
+          uint32_t m = data->moduli[i];
+          uint32_t sum =
+              (uint32_t)((powmod(a, data->x, m) + powmod(b, data->y, m)) % m);
+          alive = get_bit128(data->residue_masks[i], sum);
+        }
+        if (alive)
+          row[k >> 6] |= 1ULL << (k & 63);
+      }
+    }
+
+    data->fused_mask |= members;
   }
+  return true;
+}
 
-  /* Allocate and compute by_mod (Prime-major for SIMD optimization) */
-  data->by_mod = (uint8_t **)malloc(NUM_SIEVE_PRIMES * sizeof(uint8_t *));
-  if (!data->by_mod) {
-    /* Cleanup data->ax_mod first... */
-    return NULL;
+/**
+ * Release the prefix-pattern cache.
+ */
+static void free_prefix(PrecomputedData *data) {
+  free(data->prefix.patterns);
+  memset(&data->prefix, 0, sizeof(data->prefix));
+}
+
+/**
+ * Build the prefix-pattern cache.
+ */
+bool precompute_build_prefix(PrecomputedData *data, uint64_t rows,
+                             uint64_t cols) {
+  free_prefix(data);
+  PrefixCache *pc = &data->prefix;
+
+  /* Distinct A^x residues per modulus, and the value of each digit */
+  uint8_t values[MAX_SIEVE_MODULI][MAX_SIEVE_MODULUS];
+  uint32_t radix[MAX_SIEVE_MODULI];
+  uint32_t period = 1, keys = 1;
+  uint32_t members = 0;
+  int num_members = 0;
+
+  for (int t = 0; t < data->num_moduli; t++) {
+    int i = data->order[t];
+    uint32_t m = data->moduli[i];
+    if ((data->fused_mask & (1u << i)) || gcd64(period, m) != 1 ||
+        period * m > MAX_PREFIX_PERIOD)
+      continue;
+
+    bool seen[MAX_SIEVE_MODULUS] = {false};
+    uint32_t distinct = 0;
+    for (uint32_t a = 0; a < m; a++) {
+      uint32_t r = (uint32_t)powmod(a, data->x, m);
+      if (!seen[r]) {
+        seen[r] = true;
+        values[i][distinct++] = (uint8_t)r;
+      }
+    }
+
+    uint32_t words = (period * m + 64 + 63) / 64 + 1;
+    if ((uint64_t)keys * distinct * words * sizeof(uint64_t) >
+        MAX_PREFIX_CACHE_BYTES)
+      continue;
+
+    pc->stride[i] = keys;
+    radix[i] = distinct;
+    for (uint32_t d = 0; d < distinct; d++)
+      pc->digit[i][values[i][d]] = (uint8_t)d;
+    period *= m;
+    keys *= distinct;
+    members |= 1u << i;
+    num_members++;
+  }
+
+  /* Each row saves num_members - 1 ANDs per bitmap word; building costs
+   * num_members per pattern word */
+  uint32_t row_words = (period + 64 + 63) / 64 + 1;
+  double saved = (double)rows * (double)((cols + 63) / 64) * (num_members - 1);
+  double build = (double)keys * row_words * num_members;
+  if (num_members < 2 || saved < PREFIX_MIN_GAIN * build) {
+    memset(pc, 0, sizeof(*pc));
+    return true;
+  }
+
+  pc->period = period;
+  pc->member_mask = members;
+  pc->num_members = num_members;
+  pc->row_words = row_words;
+  pc->num_keys = keys;
+  pc->patterns =
+      (uint64_t *)malloc((size_t)keys * pc->row_words * sizeof(uint64_t));
+  if (!pc->patterns) {
+    memset(pc, 0, sizeof(*pc));
+    return false;
   }
 
-  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-    uint32_t p = SIEVE_PRIMES[i];
-    data->by_mod[i] = (uint8_t *)malloc((B_max + 1) * sizeof(uint8_t));
-    for (uint64_t B = 0; B <= B_max; B++) {
-      data->by_mod[i][B] = (uint8_t)powmod(B, y, p);
+  /* Each pattern is the AND of its members' periodic b_patterns windows */
+  for (uint32_t key = 0; key < keys; key++) {
+    uint64_t *pat = pc->patterns + (size_t)key * pc->row_words;
+    for (uint32_t j = 0; j < pc->row_words; j++)
+      pat[j] = ~0ULL;
+
+    for (int i = 0; i < data->num_moduli; i++) {
+      if (!(members & (1u << i)))
+        continue;
+      uint32_t m = data->moduli[i];
+      uint32_t d = key / pc->stride[i] % radix[i];
+      const uint64_t *src =
+          data->b_patterns[i] + (size_t)values[i][d] * PATTERN_WORDS;
+      uint32_t r = 0;
+      for (uint32_t j = 0; j < pc->row_words; j++) {
+        pat[j] &= pattern_window(src, r);
+        r = (r + 64) % m;
+      }
     }
   }
+  return true;
+}
 
-  return data;
+/**
+ * Release the wheel, built or mapped.
+ */
+static void free_wheel(PrecomputedData *data) {
+  SieveWheel *wh = &data->wheel;
+  if (wh->map.base) {
+    cache_unmap(&wh->map);
+  } else {
+    free(wh->offsets);
+    free(wh->classes);
+  }
+  memset(wh, 0, sizeof(*wh));
 }
 
 /**
- * Free all precomputed data.
+ * Cache key of a wheel: the signature and the member moduli.
  */
-void precompute_free(PrecomputedData *data) {
-  if (!data)
-    return;
+static uint64_t wheel_key(const PrecomputedData *data, uint32_t members) {
+  uint32_t in[3 + MAX_SIEVE_MODULI] = {data->x, data->y, data->z};
+  int n = 3;
+  for (int i = 0; i < data->num_moduli; i++) {
+    if (members & (1u << i))
+      in[n++] = data->moduli[i];
+  }
+  return cache_hash(CACHE_HASH_INIT, in, (size_t)n * sizeof(uint32_t));
+}
+
+/**
+ * Point the wheel at its cached tables: {W, classes}, offsets[W + 1],
+ * classes[]. Returns false if there is no usable file.
+ */
+static bool map_wheel(PrecomputedData *data, uint64_t key, uint32_t W) {
+  SieveWheel *wh = &data->wheel;
+  uint64_t bytes;
+  const uint8_t *p =
+      cache_map(data->cache_dir, CACHE_KIND_WHEEL, key, &wh->map, &bytes);
+  if (!p)
+    return false;
+
+  const uint32_t *head = (const uint32_t *)p;
+  size_t offset_bytes = cache_align((W + 1) * sizeof(uint32_t));
+  if (bytes < 8 || head[0] != W ||
+      bytes != 8 + offset_bytes + cache_align(head[1] * sizeof(uint16_t))) {
+    cache_unmap(&wh->map);
+    return false;
+  }
+  wh->offsets = (uint32_t *)(p + 8);
+  wh->classes = (uint16_t *)(p + 8 + offset_bytes);
+  return true;
+}
+
+/**
+ * Build the residue-class wheel.
+ */
+bool precompute_build_wheel(PrecomputedData *data) {
+  SieveWheel *wh = &data->wheel;
+  free_wheel(data);
+
+  uint32_t W = 1;
+  uint32_t members = 0;
+  for (int t = 0; t < data->num_moduli; t++) {
+    int i = data->order[t];
+    uint32_t m = data->moduli[i];
+    if (gcd64(W, m) != 1 || W * m > MAX_WHEEL_MODULUS)
+      continue;
+    W *= m;
+    members |= 1u << i;
+  }
+
+  uint64_t key = data->cache_dir ? wheel_key(data, members) : 0;
+  if (data->cache_dir && map_wheel(data, key, W)) {
+    wh->modulus = W;
+    wh->member_mask = members;
+    return true;
+  }
 
-  if (data->ax_mod) {
-    for (uint64_t A = 0; A <= data->A_max; A++) {
-      free(data->ax_mod[A]);
+  /* Per-member residues of a^x and b^y for a, b < W */
+  uint8_t *ra = (uint8_t *)malloc((size_t)MAX_SIEVE_MODULI * W);
+  uint8_t *rb = (uint8_t *)malloc((size_t)MAX_SIEVE_MODULI * W);
+  wh->offsets = (uint32_t *)calloc(W + 1, sizeof(uint32_t));
+  if (!ra || !rb || !wh->offsets) {
+    free(ra);
+    free(rb);
+    free(wh->offsets);
+    wh->offsets = NULL;
+    return false;
+  }
+  const KernelSet *ks = kernel_active();
+  for (int i = 0; i < data->num_moduli; i++) {
+    if (!(members & (1u << i)))
+      continue;
+    ks->pow_table8(ra + (size_t)i * W, W, data->x, data->moduli[i]);
+    ks->pow_table8(rb + (size_t)i * W, W, data->y, data->moduli[i]);
+  }
+
+  /* Two passes: count the live classes per a, then fill them */
+  for (int pass = 0; pass < 2; pass++) {
+    uint32_t n = 0;
+    for (uint32_t a = 0; a < W; a++) {
+      wh->offsets[a] = n;
+      for (uint32_t b = 0; b < W; b++) {
+        /* A shared member prime means gcd(A, B) > 1: never an exact check */
+        bool alive = gcd64(gcd64(a, b), W) == 1;
+        for (int i = 0; i < data->num_moduli && alive; i++) {
+          if (!(members & (1u << i)))
+            continue;
+          uint32_t m = data->moduli[i];
+          uint32_t sum = ra[(size_t)i * W + a] + rb[(size_t)i * W + b];
+          if (sum >= m)
+            sum -= m;
+          alive = get_bit128(data->residue_masks[i], sum);
+        }
+        if (alive) {
+          if (pass)
+            wh->classes[n] = (uint16_t)b;
+          n++;
+        }
+      }
+    }
+    wh->offsets[W] = n;
+
+    if (!pass) {
+      wh->classes = (uint16_t *)malloc((n ? n : 1) * sizeof(uint16_t));
+      if (!wh->classes) {
+        free(ra);
+        free(rb);
+        free(wh->offsets);
+        wh->offsets = NULL;
+        return false;
+      }
     }
-    free(data->ax_mod);
   }
 
-  if (data->by_mod) {
-    for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-      free(data->by_mod[i]);
+  free(ra);
+  free(rb);
+  wh->modulus = W;
+  wh->member_mask = members;
+
+  if (data->cache_dir) {
+    uint32_t head[2] = {W, wh->offsets[W]};
+    CachePart parts[3] = {
+        {head, sizeof(head)},
+        {wh->offsets, (W + 1) * sizeof(uint32_t)},
+        {wh->classes, head[1] * sizeof(uint16_t)},
+    };
+    cache_store(data->cache_dir, CACHE_KIND_WHEEL, key, parts, 3);
+  }
+  return true;
+}
+
+/**
+ * Release a deep bank.
+ */
+static void free_bank(DeepBank *bank) {
+  cache_unmap(&bank->map);
+  arena_free(&bank->arena);
+  free(bank->primes);
+  bank->primes = NULL;
+  bank->count = 0;
+}
+
+/**
+ * Assign each bank prime its pow[2p] and residue mask slots in base (or just
+ * size them when base is NULL). The layout is that of the cache file after
+ * the prime list. Returns the bytes used.
+ */
+static size_t layout_bank(DeepBank *bank, const uint32_t *primes, int n,
+                          uint8_t *base) {
+  size_t at = 0;
+  for (int d = 0; d < n; d++) {
+    size_t q = primes[d];
+    bank->primes[d].modulus = (uint32_t)q;
+    bank->primes[d].pow = (uint16_t *)arena_slot(
+        base, &at, 2 * q * sizeof(uint16_t), sizeof(uint64_t));
+    bank->primes[d].residue_mask = (uint64_t *)arena_slot(
+        base, &at, (q + 63) / 64 * sizeof(uint64_t), sizeof(uint64_t));
+  }
+  return at;
+}
+
+/**
+ * Point bank (with primes[] allocated) at its cached tables: the prime list,
+ * then pow[2p] and the residue mask of each prime. Returns false if there is
+ * no usable file.
+ */
+static bool map_bank(const char *dir, uint64_t key, const uint32_t *primes,
+                     int n, DeepBank *bank) {
+  uint64_t bytes;
+  const uint8_t *p = cache_map(dir, CACHE_KIND_DEEP, key, &bank->map, &bytes);
+  if (!p)
+    return false;
+
+  size_t head = cache_align((size_t)n * sizeof(uint32_t));
+  if (head + layout_bank(bank, primes, n, NULL) != bytes ||
+      memcmp(p, primes, (size_t)n * sizeof(uint32_t)) != 0) {
+    cache_unmap(&bank->map);
+    return false;
+  }
+  layout_bank(bank, primes, n, (uint8_t *)p + head);
+  bank->count = n;
+  return true;
+}
+
+/**
+ * Fill bank with the count best primes for exponent z, skipping those that
+ * divide one of data's sieve moduli.
+ */
+static bool build_bank(const PrecomputedData *data, uint32_t z, int count,
+                       DeepBank *bank) {
+  free_bank(bank);
+  if (count > MAX_DEEP_PRIMES)
+    count = MAX_DEEP_PRIMES;
+
+  uint32_t primes[MAX_DEEP_PRIMES];
+  int n = rank_primes(z, count, data, primes);
+  if (n == 0)
+    return true;
+
+  bank->primes = (DeepPrime *)calloc((size_t)n, sizeof(DeepPrime));
+  if (!bank->primes)
+    return false;
+
+  /* Keyed by the ranked primes themselves, which already reflect data's
+   * moduli */
+  uint64_t key = 0;
+  if (data->cache_dir) {
+    uint32_t sig[3] = {data->x, data->y, z};
+    key = cache_hash(CACHE_HASH_INIT, sig, sizeof(sig));
+    key = cache_hash(key, primes, (size_t)n * sizeof(uint32_t));
+    if (map_bank(data->cache_dir, key, primes, n, bank))
+      return true;
+  }
+
+  size_t bytes = layout_bank(bank, primes, n, NULL);
+  if (!arena_alloc(&bank->arena, bytes)) {
+    free_bank(bank);
+    return false;
+  }
+  layout_bank(bank, primes, n, (uint8_t *)bank->arena.base);
+  bank->count = n;
+
+  const KernelSet *ks = kernel_active();
+  bool ok = true;
+#pragma omp parallel for schedule(dynamic, 8) reduction(&& : ok)
+  for (int d = 0; d < n; d++) {
+    DeepPrime *dp = &bank->primes[d];
+    uint32_t p = dp->modulus;
+    ok = fill_residue_mask(dp->residue_mask, p, z) && ok;
+    ks->pow_table16(dp->pow, p, data->x, p);
+    ks->pow_table16(dp->pow + p, p, data->y, p);
+  }
+  if (!ok) {
+    free_bank(bank);
+    return false;
+  }
+
+  if (data->cache_dir) {
+    CachePart parts[2] = {{primes, (size_t)n * sizeof(uint32_t)},
+                          {bank->arena.base, bytes}};
+    cache_store(data->cache_dir, CACHE_KIND_DEEP, key, parts, 2);
+  }
+  return true;
+}
+
+/**
+ * Build the deep bank.
+ */
+bool precompute_build_deep(PrecomputedData *data, int count) {
+  return build_bank(data, data->z, count, &data->deep);
+}
+
+/**
+ * Release the z-family tables.
+ */
+static void free_family(PrecomputedData *data) {
+  ZFamily *fam = &data->family;
+  for (int w = 0; w < data->num_wide; w++) {
+    free(fam->wide_ok[w]);
+    fam->wide_ok[w] = NULL;
+  }
+  for (int k = 0; k < fam->count; k++)
+    free_bank(&fam->deep[k]);
+  fam->count = 0;
+}
+
+/**
+ * Build the z-family tables.
+ */
+bool precompute_build_family(PrecomputedData *data, const uint32_t *z,
+                             int count, int deep_count) {
+  ZFamily *fam = &data->family;
+  free_family(data);
+  if (count < 1 || count > MAX_Z_FAMILY) {
+    fprintf(stderr, "ERROR: z-family must have 1..%d members\n",
+            MAX_Z_FAMILY);
+    return false;
+  }
+
+  fam->count = count;
+  memset(fam->ok, 0, sizeof(fam->ok));
+  for (int k = 0; k < count; k++) {
+    fam->z[k] = z[k];
+    for (int i = 0; i < data->num_moduli; i++) {
+      uint64_t *mask = fam->residue_masks[k][i];
+      compute_residue_mask128(data->moduli[i], z[k], mask);
+      for (uint32_t s = 0; s < data->moduli[i]; s++)
+        fam->ok[i][s] |= (uint8_t)(get_bit128(mask, s) << k);
+    }
+  }
+
+  for (int w = 0; w < data->num_wide; w++) {
+    uint32_t m = data->wide[w].modulus;
+    fam->wide_ok[w] = (uint8_t *)calloc(m, 1);
+    if (!fam->wide_ok[w]) {
+      free_family(data);
+      return false;
+    }
+    for (int k = 0; k < count; k++) {
+      uint64_t *mask = (uint64_t *)calloc((m + 63) / 64, sizeof(uint64_t));
+      if (!mask || !fill_residue_mask(mask, m, z[k])) {
+        free(mask);
+        free_family(data);
+        return false;
+      }
+      for (uint32_t s = 0; s < m; s++)
+        fam->wide_ok[w][s] |=
+            (uint8_t)(((mask[s >> 6] >> (s & 63)) & 1) << k);
+      free(mask);
+    }
+  }
+
+  for (int k = 0; k < count; k++) {
+    if (deep_count > 0 && !build_bank(data, z[k], deep_count, &fam->deep[k])) {
+      free_family(data);
+      return false;
+    }
+  }
+  return true;
+}
+
+/* A values per factor-sieve segment (128 KiB of table) */
+#define FACTOR_SEGMENT 65536u
+
+/**
+ * Build the smallest-prime-factor table by a segmented sieve of
+ * Eratosthenes over the A window only.
+ */
+bool precompute_build_factors(PrecomputedData *data) {
+  FactorTable *ft = &data->factors;
+  arena_free(&ft->arena);
+  ft->spf = NULL;
+  ft->base = 0;
+  ft->limit = 0;
+
+  if (data->A_start > FACTOR_TABLE_LIMIT)
+    return true; /* Every row is factored by trial division */
+  uint32_t base = (uint32_t)data->A_start;
+  uint32_t limit = data->A_max < FACTOR_TABLE_LIMIT ? (uint32_t)data->A_max
+                                                    : FACTOR_TABLE_LIMIT;
+  uint32_t count = limit - base + 1;
+  if (!arena_alloc(&ft->arena, (size_t)count * sizeof(uint16_t)))
+    return false;
+
+  /* Sieving primes up to sqrt(limit) < 2^12 */
+  uint32_t root = 1;
+  while ((root + 1) * (root + 1) <= limit)
+    root++;
+  uint8_t composite[4097] = {0};
+  uint16_t primes[4096];
+  uint32_t np = 0;
+  for (uint32_t p = 2; p <= root; p++) {
+    if (composite[p])
+      continue;
+    primes[np++] = (uint16_t)p;
+    for (uint32_t n = p * p; n <= root; n += p)
+      composite[n] = 1;
+  }
+
+  uint16_t *spf = (uint16_t *)ft->arena.base;
+  uint32_t segments = (count + FACTOR_SEGMENT - 1) / FACTOR_SEGMENT;
+#pragma omp parallel for schedule(dynamic, 1)
+  for (uint32_t s = 0; s < segments; s++) {
+    uint32_t lo = base + s * FACTOR_SEGMENT;
+    uint32_t hi = count - s * FACTOR_SEGMENT > FACTOR_SEGMENT
+                      ? lo + FACTOR_SEGMENT - 1
+                      : limit;
+    for (uint32_t i = 0; i < np; i++) {
+      uint32_t p = primes[i];
+      if (p > hi / p)
+        break;
+      uint32_t n = (lo + p - 1) / p * p;
+      if (n < p * p)
+        n = p * p;
+      for (; n <= hi; n += p) {
+        if (!spf[n - base])
+          spf[n - base] = (uint16_t)p;
+      }
     }
-    free(data->by_mod);
   }
 
+  ft->spf = spf;
+  ft->base = base;
+  ft->limit = limit;
+  return true;
+}
+
+/**
+ * Bytes of a deep bank's tables, built or mapped.
+ */
+static size_t bank_bytes(const DeepBank *bank) {
+  return bank->arena.size + bank->map.size +
+         (size_t)bank->count * sizeof(DeepPrime);
+}
+
+/**
+ * Sum the sizes of every table data holds.
+ */
+size_t precompute_table_bytes(const PrecomputedData *data) {
+  size_t bytes = data->arena.size + data->factors.arena.size;
+
+  for (int g = 0; g < data->num_fused; g++) {
+    const FusedGroup *grp = &data->fused[g];
+    bytes += (size_t)grp->modulus * grp->row_words * sizeof(uint64_t);
+  }
+
+  const PrefixCache *pc = &data->prefix;
+  bytes += (size_t)pc->num_keys * pc->row_words * sizeof(uint64_t);
+
+  const SieveWheel *wh = &data->wheel;
+  if (wh->map.base)
+    bytes += wh->map.size;
+  else if (wh->modulus)
+    bytes += ((size_t)wh->modulus + 1) * sizeof(uint32_t) +
+             (size_t)wh->offsets[wh->modulus] * sizeof(uint16_t);
+
+  bytes += bank_bytes(&data->deep);
+
+  const ZFamily *fam = &data->family;
+  for (int k = 0; k < fam->count; k++)
+    bytes += bank_bytes(&fam->deep[k]);
+  for (int w = 0; fam->count && w < data->num_wide; w++)
+    bytes += data->wide[w].modulus;
+  return bytes;
+}
+
+/**
+ * Free all precomputed data.
+ */
+void precompute_free(PrecomputedData *data) {
+  if (!data)
+    return;
+
+  arena_free(&data->arena);
+  arena_free(&data->factors.arena);
+  free_fused(data);
+  free_wheel(data);
+  free_prefix(data);
+  free_bank(&data->deep);
+  free_family(data);
   free(data);
 }
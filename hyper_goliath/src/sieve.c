@@ -4,21 +4,56 @@
 
 #include "hyper_goliath.h"
 
-#ifdef HAVE_AVX2
-#include <immintrin.h>
-#endif
+#include <stdlib.h>
+#include <string.h>
 
 /**
- * Scalar sieve check - reference implementation (now uses prime-major by_mod).
+ * (A^x + B^y) mod the wide modulus.
+ */
+static inline uint32_t wide_sum(const WideModulus *w, uint64_t A, uint64_t B) {
+  uint32_t m = w->modulus;
+  uint32_t sum = (uint32_t)w->pow[barrett64_reduce(A, w->reduce)] +
+                 w->pow[m + barrett64_reduce(B, w->reduce)];
+  return sum >= m ? sum - m : sum;
+}
+
+/**
+ * Wide-tier check: moduli above MAX_SIEVE_MODULUS, 16-bit tables.
+ * Only reached by pairs that already survived the byte tier.
+ */
+bool sieve_wide_survives(uint64_t A, uint64_t B, const PrecomputedData *data) {
+  for (int t = 0; t < data->num_wide; t++) {
+    const WideModulus *w = &data->wide[data->wide_order[t]];
+    uint32_t sum = wide_sum(w, A, B);
+    if (!((w->residue_mask[sum >> 6] >> (sum & 63)) & 1))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Scalar sieve check - reference implementation.
+ * CRT-fused groups, when built, are tested first and their primes skipped.
  */
 bool sieve_survives_scalar(uint64_t A, uint64_t B,
                            const PrecomputedData *data) {
-  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-    uint32_t p = SIEVE_PRIMES[i];
-    uint8_t ax_mod = data->ax_mod[A][i];
-    uint8_t by_mod = data->by_mod[i][B];
+  for (int g = 0; g < data->num_fused; g++) {
+    const FusedGroup *grp = &data->fused[g];
+    const uint64_t *row =
+        grp->rows +
+        (size_t)barrett64_reduce(A, grp->reduce) * grp->row_words;
+    uint32_t b = barrett64_reduce(B, grp->reduce);
+    if (!((row[b >> 6] >> (b & 63)) & 1))
+      return false;
+  }
 
-    uint32_t sum = ax_mod + by_mod;
+  for (int t = 0; t < data->num_moduli; t++) {
+    int i = data->order[t];
+    if (data->fused_mask & (1u << i))
+      continue;
+
+    uint32_t p = data->moduli[i];
+    uint32_t sum = sieve_ax(data, i, A) + sieve_by(data, i, B);
     if (sum >= p)
       sum -= p;
 
@@ -26,57 +61,541 @@ bool sieve_survives_scalar(uint64_t A, uint64_t B,
       return false;
     }
   }
+  return sieve_wide_survives(A, B, data);
+}
+
+/**
+ * Wide tier for a z-family: clears the bits of alive whose signature some
+ * wide modulus kills.
+ */
+uint32_t sieve_family_wide(uint64_t A, uint64_t B, const PrecomputedData *data,
+                           uint32_t alive) {
+  for (int t = 0; t < data->num_wide && alive; t++) {
+    int w = data->wide_order[t];
+    alive &= data->family.wide_ok[w][wide_sum(&data->wide[w], A, B)];
+  }
+  return alive;
+}
+
+/**
+ * z-family sieve check: each sum residue is computed once and looked up in
+ * the packed ok[] table, which ANDs every family member's test at once.
+ */
+uint32_t sieve_family_scalar(uint64_t A, uint64_t B,
+                             const PrecomputedData *data) {
+  const ZFamily *fam = &data->family;
+  uint32_t alive = (1u << fam->count) - 1;
+
+  for (int t = 0; t < data->num_moduli && alive; t++) {
+    int i = data->order[t];
+    uint32_t p = data->moduli[i];
+    uint32_t sum = sieve_ax(data, i, A) + sieve_by(data, i, B);
+    if (sum >= p)
+      sum -= p;
+    alive &= fam->ok[i][sum];
+  }
+  return sieve_family_wide(A, B, data, alive);
+}
+
+/**
+ * The cached prefix pattern for row A (data->prefix must be built).
+ */
+static inline const uint64_t *prefix_pattern(uint64_t A,
+                                             const PrecomputedData *data) {
+  const PrefixCache *pc = &data->prefix;
+  uint32_t key = 0;
+  for (uint32_t m = pc->member_mask; m; m &= m - 1) {
+    int i = __builtin_ctz(m);
+    key += pc->stride[i] * pc->digit[i][sieve_ax(data, i, A)];
+  }
+  return pc->patterns + (size_t)key * pc->row_words;
+}
+
+/**
+ * AND the fused-group patterns, the cached prefix pattern (which counts as
+ * its members) and the first n_prefix remaining moduli of data->order into
+ * out[0..nwords). Returns false once the block is all dead.
+ */
+static bool row_bitmap_apply(uint64_t A, uint64_t B_start, size_t nwords,
+                             uint64_t *out, const PrecomputedData *data,
+                             int n_prefix) {
+  memset(out, 0xFF, nwords * sizeof(uint64_t));
+
+  for (int g = 0; g < data->num_fused; g++) {
+    const FusedGroup *grp = &data->fused[g];
+    uint32_t M = grp->modulus;
+    const uint64_t *pat =
+        grp->rows +
+        (size_t)barrett64_reduce(A, grp->reduce) * grp->row_words;
+    uint32_t r = barrett64_reduce(B_start, grp->reduce);
+    uint32_t step = 64 % M;
+
+    for (size_t j = 0; j < nwords; j++) {
+      out[j] &= pattern_window(pat, r);
+      r += step;
+      if (r >= M)
+        r -= M;
+    }
+  }
+
+  /* A cached prefix pattern stands in for all of its members at once */
+  const PrefixCache *pc = &data->prefix;
+  int applied = 0;
+  if (pc->period) {
+    const uint64_t *pat = prefix_pattern(A, data);
+    uint32_t r = (uint32_t)(B_start % pc->period);
+    uint32_t step = 64 % pc->period;
+    for (size_t j = 0; j < nwords; j++) {
+      out[j] &= pattern_window(pat, r);
+      r += step;
+      if (r >= pc->period)
+        r -= pc->period;
+    }
+    applied = pc->num_members;
+  }
+
+  uint32_t skip = data->fused_mask | pc->member_mask;
+  for (int t = 0; t < data->num_moduli && applied < n_prefix; t++) {
+    int i = data->order[t];
+    if (skip & (1u << i))
+      continue;
+    applied++;
+
+    uint32_t p = data->moduli[i];
+    const uint64_t *pat =
+        data->b_patterns[i] + (size_t)sieve_ax(data, i, A) * PATTERN_WORDS;
+    uint32_t r = sieve_b_offset(data, i, B_start);
+    uint32_t step = 64 % p;
+
+    uint64_t any = 0;
+    for (size_t j = 0; j < nwords; j++) {
+      out[j] &= pattern_window(pat, r);
+      any |= out[j];
+      r += step;
+      if (r >= p)
+        r -= p;
+    }
+
+    /* Whole block dead: the remaining moduli cannot revive it */
+    if (!any)
+      return false;
+  }
   return true;
 }
 
-#ifdef HAVE_AVX2
+/**
+ * Row-bitmap sieve for a fixed A.
+ *
+ * Whether B survives prime p depends only on B mod p, so for each prime the
+ * survivors form a periodic pattern over B. We walk the block 64 B values at
+ * a time, tracking B mod p incrementally, and AND one pattern window per
+ * prime into each word: roughly 20 word operations per 64 pairs instead of
+ * 20 table lookups per pair. A fused group's row is itself a periodic pattern
+ * (period M), so it stands in for all of its primes. Wide-tier moduli have
+ * periods too long for patterns and are checked per surviving bit. Bits past
+ * B_max are only padding in the block's last word, so they are cleared there
+ * instead of being tested.
+ */
+void sieve_row_bitmap(uint64_t A, uint64_t B_start, size_t nwords,
+                      uint64_t *out, const PrecomputedData *data) {
+  if (!row_bitmap_apply(A, B_start, nwords, out, data, data->num_moduli))
+    return;
+
+  if (data->num_wide) {
+    for (size_t j = 0; j < nwords; j++) {
+      uint64_t B0 = B_start + 64 * j;
+      for (uint64_t live = out[j]; live; live &= live - 1) {
+        int k = __builtin_ctzll(live);
+        if (B0 + k > data->B_max || !sieve_wide_survives(A, B0 + k, data))
+          out[j] &= ~(1ULL << k);
+      }
+    }
+  }
+}
 
 /**
- * Optimized sieve check for 8 B values at once.
- * Leverages prime-major layout for contiguous memory access.
+ * B^y mod moduli[i] for B in [B_start, B_start + count), copied out of the
+ * periodic row in runs of at least SIEVE_LANE_PAD bytes.
  */
-uint8_t sieve_survives_avx2_8(uint64_t A, uint64_t B_start,
-                              const PrecomputedData *data) {
-  uint8_t survivors = 0xFF;
+static void sieve_b_residues(const PrecomputedData *data, int i,
+                             uint64_t B_start, size_t count, uint8_t *out) {
+  uint32_t m = data->moduli[i];
+  uint32_t b = sieve_b_offset(data, i, B_start);
+  for (size_t j = 0; j < count;) {
+    size_t run = m + SIEVE_LANE_PAD - b;
+    if (run > count - j)
+      run = count - j;
+    memcpy(out + j, data->by_pow[i] + b, run);
+    j += run;
+    b = (uint32_t)((b + run) % m);
+  }
+}
 
-  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-    uint32_t p = SIEVE_PRIMES[i];
-    uint8_t ax = data->ax_mod[A][i];
-    const uint8_t *by_row = data->by_mod[i];
+/**
+ * Bit-sliced sieve: the row-bitmap idea turned sideways.
+ *
+ * For a fixed B, survival under modulus m is periodic in A (period m) with a
+ * pattern selected by B^y mod m, so one 64-bit window of the transposed
+ * pattern gives the verdict for 64 consecutive A at once. A mod m is fixed
+ * for the whole tile; per B each modulus costs a byte load, a window
+ * extraction and an AND, with no SIMD required. Moduli are applied in the
+ * profiled order over the whole B block, stopping once it is all dead.
+ */
+void sieve_sliced_tile(uint64_t A_start, uint64_t B_start, size_t count,
+                       uint64_t *out, const PrecomputedData *data) {
+  uint8_t by[SIEVE_ROW_BLOCK];
+
+  uint64_t live = ~0ULL;
+  if (A_start + 63 > data->A_max)
+    live = data->A_max >= A_start
+               ? (1ULL << (data->A_max - A_start + 1)) - 1
+               : 0;
+  for (size_t j = 0; j < count; j++)
+    out[j] = live;
+
+  for (int t = 0; t < data->num_moduli; t++) {
+    int i = data->order[t];
+    const uint64_t *pats = data->a_patterns[i];
+    uint32_t r = barrett64_reduce(A_start, data->reduce[i]);
+    sieve_b_residues(data, i, B_start, count, by);
+
+    uint64_t any = 0;
+    for (size_t j = 0; j < count; j++) {
+      out[j] &= pattern_window(pats + (size_t)by[j] * PATTERN_WORDS, r);
+      any |= out[j];
+    }
+    if (!any)
+      return;
+  }
+
+  if (data->num_wide) {
+    for (size_t j = 0; j < count; j++) {
+      for (uint64_t bits = out[j]; bits; bits &= bits - 1) {
+        int k = __builtin_ctzll(bits);
+        if (!sieve_wide_survives(A_start + k, B_start + j, data))
+          out[j] &= ~(1ULL << k);
+      }
+    }
+  }
+}
+
+/**
+ * Tiered sieve, tier 1: the cheapest-to-apply, highest-kill moduli only.
+ */
+void sieve_row_prefix(uint64_t A, uint64_t B_start, size_t nwords,
+                      uint64_t *out, const PrecomputedData *data,
+                      int n_prefix) {
+  row_bitmap_apply(A, B_start, nwords, out, data, n_prefix);
+}
+
+/**
+ * Stream compaction of a survivor bitmap into B offsets.
+ */
+size_t sieve_compact_bits(const uint64_t *bits, size_t nwords, uint32_t *idx) {
+  size_t n = 0;
+  for (size_t j = 0; j < nwords; j++) {
+    for (uint64_t live = bits[j]; live; live &= live - 1)
+      idx[n++] = (uint32_t)(64 * j + __builtin_ctzll(live));
+  }
+  return n;
+}
+
+/**
+ * Tiered sieve, tier 2.
+ *
+ * Modulus-major over the dense offset list: each pass is a branch-free loop
+ * that always stores the offset and advances the write cursor by the
+ * survival bit, so the unpredictable kill/survive outcome never becomes a
+ * branch. Passes stop early once nothing is left.
+ */
+size_t sieve_filter_compact(uint64_t A, uint64_t B_start, uint32_t *idx,
+                            size_t n, const PrecomputedData *data,
+                            int n_prefix) {
+  for (int g = 0; n_prefix < 0 && g < data->num_fused && n; g++) {
+    const FusedGroup *grp = &data->fused[g];
+    const uint64_t *row =
+        grp->rows +
+        (size_t)barrett64_reduce(A, grp->reduce) * grp->row_words;
+
+    size_t kept = 0;
+    for (size_t s = 0; s < n; s++) {
+      uint32_t k = idx[s];
+      uint32_t b = barrett64_reduce(B_start + k, grp->reduce);
+      idx[kept] = k;
+      kept += (row[b >> 6] >> (b & 63)) & 1;
+    }
+    n = kept;
+  }
+
+  /* Mirror row_bitmap_apply(): the prefix cache counts as its members */
+  uint32_t skip = data->fused_mask;
+  int seen = 0;
+  if (n_prefix >= 0 && data->prefix.period) {
+    skip |= data->prefix.member_mask;
+    seen = data->prefix.num_members;
+  }
+  for (int t = 0; t < data->num_moduli && n; t++) {
+    int i = data->order[t];
+    if (skip & (1u << i))
+      continue;
+    if (seen++ < n_prefix)
+      continue;
+
+    uint32_t p = data->moduli[i];
+    uint32_t ax = sieve_ax(data, i, A);
     const uint64_t *mask = data->residue_masks[i];
 
-    /*
-     * Heat-seeker optimization:
-     * Contiguous access to 8 B values. The compiler can easily
-     * vectorize this or use efficient registers.
-     */
-    for (int l = 0; l < 8; l++) {
-      if (!(survivors & (1 << l)))
+    size_t kept = 0;
+    for (size_t s = 0; s < n; s++) {
+      uint32_t k = idx[s];
+      uint32_t sum = ax + sieve_by(data, i, B_start + k);
+      sum -= sum >= p ? p : 0;
+      idx[kept] = k;
+      kept += (mask[sum >> 6] >> (sum & 63)) & 1;
+    }
+    n = kept;
+  }
+
+  for (int t = 0; t < data->num_wide && n; t++) {
+    const WideModulus *w = &data->wide[data->wide_order[t]];
+    uint32_t m = w->modulus;
+    uint32_t ax = w->pow[barrett64_reduce(A, w->reduce)];
+    const uint16_t *by = w->pow + m;
+
+    size_t kept = 0;
+    for (size_t s = 0; s < n; s++) {
+      uint32_t k = idx[s];
+      uint32_t sum = ax + by[barrett64_reduce(B_start + k, w->reduce)];
+      sum -= sum >= m ? m : 0;
+      idx[kept] = k;
+      kept += (w->residue_mask[sum >> 6] >> (sum & 63)) & 1;
+    }
+    n = kept;
+  }
+  return n;
+}
+
+/**
+ * Does byte-tier modulus i kill (A, B)?
+ */
+static inline bool byte_kills(int i, uint64_t A, uint64_t B,
+                              const PrecomputedData *data) {
+  uint32_t p = data->moduli[i];
+  uint32_t sum = sieve_ax(data, i, A) + sieve_by(data, i, B);
+  if (sum >= p)
+    sum -= p;
+  return !get_bit128(data->residue_masks[i], sum);
+}
+
+/**
+ * Does wide-tier modulus w kill (A, B)?
+ */
+static inline bool wide_kills(int w, uint64_t A, uint64_t B,
+                              const PrecomputedData *data) {
+  const WideModulus *wm = &data->wide[w];
+  uint32_t sum = wide_sum(wm, A, B);
+  return !((wm->residue_mask[sum >> 6] >> (sum & 63)) & 1);
+}
+
+/**
+ * Greedy ordering of one tier: repeatedly pick the candidate that kills the
+ * most still-alive samples. kills[s] has bit c set iff candidate c kills
+ * sample s; alive[] is compacted in place. Returns the number still alive.
+ */
+static size_t greedy_order(const uint64_t *kills, uint32_t *alive,
+                           size_t n_alive, uint64_t candidates, int n_cand,
+                           uint8_t *order_out, double *rate_out) {
+  for (int step = 0; step < n_cand; step++) {
+    uint64_t counts[64] = {0};
+    for (size_t s = 0; s < n_alive; s++) {
+      for (uint64_t k = kills[alive[s]] & candidates; k; k &= k - 1)
+        counts[__builtin_ctzll(k)]++;
+    }
+
+    int best = __builtin_ctzll(candidates);
+    for (uint64_t c = candidates; c; c &= c - 1) {
+      int idx = __builtin_ctzll(c);
+      if (counts[idx] > counts[best])
+        best = idx;
+    }
+
+    order_out[step] = (uint8_t)best;
+    rate_out[step] = n_alive ? (double)counts[best] / n_alive : 0.0;
+    candidates &= ~(1ULL << best);
+
+    size_t kept = 0;
+    for (size_t s = 0; s < n_alive; s++) {
+      if (!((kills[alive[s]] >> best) & 1))
+        alive[kept++] = alive[s];
+    }
+    n_alive = kept;
+  }
+  return n_alive;
+}
+
+/**
+ * Profile kill rates and reorder the sieve moduli.
+ */
+void sieve_profile_order(PrecomputedData *data, uint64_t A_lo, uint64_t A_hi,
+                         uint64_t B_lo, uint64_t B_hi, SieveProfile *out) {
+  memset(out, 0, sizeof(*out));
+
+  uint64_t rows = A_hi - A_lo + 1;
+  uint64_t cols = B_hi - B_lo + 1;
+  uint64_t n_rows = rows < 2048 ? rows : 2048;
+  uint64_t n_cols = cols < 128 ? cols : 128;
+
+  uint64_t *kills = (uint64_t *)malloc(n_rows * n_cols * sizeof(uint64_t));
+  uint64_t *wide_kills_mask =
+      (uint64_t *)malloc(n_rows * n_cols * sizeof(uint64_t));
+  uint32_t *alive = (uint32_t *)malloc(n_rows * n_cols * sizeof(uint32_t));
+  if (!kills || !wide_kills_mask || !alive) {
+    free(kills);
+    free(wide_kills_mask);
+    free(alive);
+    return;
+  }
+
+  /* Kill masks for coprime sample pairs; pairs killed by a fused group are
+   * dropped since the groups always run first. */
+  size_t n = 0;
+  for (uint64_t r = 0; r < n_rows; r++) {
+    uint64_t A = A_lo + r * rows / n_rows;
+    for (uint64_t c = 0; c < n_cols; c++) {
+      uint64_t B = B_lo + c * cols / n_cols;
+      if (gcd64(A, B) > 1)
         continue;
+      out->sampled_pairs++;
 
-      uint64_t B = B_start + l;
-      if (B > data->B_max) {
-        survivors &= ~(1 << l);
+      uint64_t k = 0;
+      for (int i = 0; i < data->num_moduli; i++) {
+        if (byte_kills(i, A, B, data))
+          k |= 1ULL << i;
+      }
+      if (k & data->fused_mask)
         continue;
+
+      uint64_t kw = 0;
+      for (int w = 0; w < data->num_wide; w++) {
+        if (wide_kills(w, A, B, data))
+          kw |= 1ULL << w;
       }
 
-      uint32_t sum = ax + by_row[B];
-      if (sum >= p)
-        sum -= p;
+      kills[n] = k;
+      wide_kills_mask[n] = kw;
+      alive[n] = (uint32_t)n;
+      n++;
+    }
+  }
 
-      if (!get_bit128(mask, sum)) {
-        survivors &= ~(1 << l);
-      }
+  /* Byte tier: order the non-fused moduli, then park fused members last */
+  uint64_t candidates = 0;
+  int n_cand = 0;
+  for (int i = 0; i < data->num_moduli; i++) {
+    if (!(data->fused_mask & (1u << i))) {
+      candidates |= 1ULL << i;
+      n_cand++;
     }
+  }
+
+  uint8_t order[MAX_SIEVE_MODULI];
+  double rates[MAX_MODULI_LIST];
+  size_t n_alive =
+      greedy_order(kills, alive, n, candidates, n_cand, order, rates);
+  int t = n_cand;
+  for (int i = 0; i < data->num_moduli; i++) {
+    if (data->fused_mask & (1u << i))
+      order[t++] = (uint8_t)i;
+  }
+  memcpy(data->order, order, (size_t)data->num_moduli);
+
+  for (int s = 0; s < n_cand; s++) {
+    out->moduli[out->count] = data->moduli[order[s]];
+    out->kill_rate[out->count++] = rates[s];
+  }
 
-    if (!survivors)
-      break;
+  /* Wide tier: order on the byte-tier survivors */
+  if (data->num_wide) {
+    uint64_t wide_all = data->num_wide == 64 ? ~0ULL
+                                             : (1ULL << data->num_wide) - 1;
+    uint8_t worder[MAX_WIDE_MODULI];
+    greedy_order(wide_kills_mask, alive, n_alive, wide_all, data->num_wide,
+                 worder, rates);
+    memcpy(data->wide_order, worder, (size_t)data->num_wide);
+
+    for (int w = 0; w < data->num_wide; w++) {
+      out->moduli[out->count] = data->wide[worder[w]].modulus;
+      out->kill_rate[out->count++] = rates[w];
+    }
   }
 
-  return survivors;
+  free(kills);
+  free(wide_kills_mask);
+  free(alive);
 }
 
-#endif /* HAVE_AVX2 */
+/**
+ * Deep-bank check. Reached only by coprime sieve survivors, so two runtime
+ * divisions per prime are cheap next to the GMP call they usually save.
+ */
+bool sieve_deep_survives(uint64_t A, uint64_t B, const DeepBank *bank) {
+  for (int d = 0; d < bank->count; d++) {
+    const DeepPrime *dp = &bank->primes[d];
+    uint32_t p = dp->modulus;
+    uint32_t sum = (uint32_t)dp->pow[A % p] + dp->pow[p + B % p];
+    if (sum >= p)
+      sum -= p;
+    if (!((dp->residue_mask[sum >> 6] >> (sum & 63)) & 1))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Parse a sieve mode name.
+ */
+bool sieve_mode_parse(const char *name, SieveMode *out) {
+  if (strcmp(name, "lanes") == 0) {
+    *out = SIEVE_MODE_LANES;
+    return true;
+  }
+  if (strcmp(name, "rows") == 0) {
+    *out = SIEVE_MODE_ROWS;
+    return true;
+  }
+  if (strcmp(name, "tiered") == 0) {
+    *out = SIEVE_MODE_TIERED;
+    return true;
+  }
+  if (strcmp(name, "wheel") == 0) {
+    *out = SIEVE_MODE_WHEEL;
+    return true;
+  }
+  if (strcmp(name, "sliced") == 0) {
+    *out = SIEVE_MODE_SLICED;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Name of a sieve mode.
+ */
+const char *sieve_mode_name(SieveMode mode) {
+  switch (mode) {
+  case SIEVE_MODE_ROWS:
+    return "rows";
+  case SIEVE_MODE_TIERED:
+    return "tiered";
+  case SIEVE_MODE_WHEEL:
+    return "wheel";
+  case SIEVE_MODE_SLICED:
+    return "sliced";
+  case SIEVE_MODE_LANES:
+  default:
+    return "lanes";
+  }
+}
 
 /**
  * Count survivors in a range.
@@ -39,3 +39,102 @@ uint64_t gcd64(uint64_t a, uint64_t b) {
 
   return a << shift;
 }
+
+/**
+ * Distinct prime factors of A, from the smallest-prime-factor table while
+ * the cofactor lies in its window, then by trial division in O(sqrt(A)).
+ */
+int factor_distinct(uint64_t A, const FactorTable *table, uint64_t *primes) {
+  int np = 0;
+  uint64_t n = A;
+  if (table && table->limit) {
+    while (n > 1 && n >= table->base && n <= table->limit) {
+      uint64_t p = table->spf[n - table->base] ? table->spf[n - table->base]
+                                                : n;
+      primes[np++] = p;
+      do
+        n /= p;
+      while (n % p == 0);
+    }
+  }
+
+  /* Any remaining factors exceed those already found */
+  uint64_t d = np ? primes[np - 1] : 2;
+  for (; d <= n / d; d += d == 2 ? 1 : 2) {
+    if (n % d == 0) {
+      primes[np++] = d;
+      while (n % d == 0)
+        n /= d;
+    }
+  }
+  if (n > 1)
+    primes[np++] = n;
+  return np;
+}
+
+/**
+ * Count of B in [lo, hi] coprime to A.
+ *
+ * Each squarefree divisor d of A contributes mu(d) * (multiples of d in the
+ * range). Cost is O(2^k) for k distinct primes, independent of the range
+ * size.
+ */
+uint64_t count_coprime_primes(const uint64_t *primes, int np, uint64_t lo,
+                              uint64_t hi) {
+  if (hi < lo)
+    return 0;
+
+  int64_t total = 0;
+  for (uint32_t s = 0; s < (1u << np); s++) {
+    uint64_t d = 1;
+    for (int i = 0; i < np; i++) {
+      if (s & (1u << i))
+        d *= primes[i];
+    }
+    int64_t multiples = (int64_t)(hi / d - (lo - 1) / d);
+    total += __builtin_parity(s) ? -multiples : multiples;
+  }
+  return (uint64_t)total;
+}
+
+/**
+ * Count of B in [lo, hi] coprime to A, by trial division of A.
+ */
+uint64_t count_coprime_range(uint64_t A, uint64_t lo, uint64_t hi) {
+  if (hi < lo)
+    return 0;
+  if (A == 0)
+    return lo <= 1 && 1 <= hi; /* gcd(0, B) = B */
+
+  uint64_t primes[MAX_DISTINCT_PRIMES];
+  int np = factor_distinct(A, NULL, primes);
+  return count_coprime_primes(primes, np, lo, hi);
+}
+
+/**
+ * Coprimality bitmap of a B block.
+ *
+ * Every bit starts set and each prime of A clears its multiples; 2, which
+ * clears half of them, is a single alternating mask per word.
+ */
+void coprime_bitmap(const uint64_t *primes, int np, uint64_t B0,
+                    size_t nwords, uint64_t *bits) {
+  uint64_t span = (uint64_t)nwords * 64;
+  int i = 0;
+  if (np > 0 && primes[0] == 2) {
+    /* Bit k is B0 + k: keep the odd ones */
+    uint64_t odd = B0 & 1 ? 0x5555555555555555ULL : 0xAAAAAAAAAAAAAAAAULL;
+    for (size_t w = 0; w < nwords; w++)
+      bits[w] = odd;
+    i = 1;
+  } else {
+    for (size_t w = 0; w < nwords; w++)
+      bits[w] = ~0ULL;
+  }
+
+  for (; i < np; i++) {
+    uint64_t p = primes[i];
+    for (uint64_t k = (p - B0 % p) % p; k < span; k += p)
+      bits[k >> 6] &= ~(1ULL << (k & 63));
+  }
+}
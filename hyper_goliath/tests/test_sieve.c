@@ -39,11 +39,11 @@ int main(int argc, char *argv[]) {
   }
 
   /* Print residue masks for verification */
-  printf("\nResidue masks (z-th powers mod p):\n");
-  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
-    uint32_t p = SIEVE_PRIMES[i];
+  printf("\nResidue masks (z-th powers mod m):\n");
+  for (int i = 0; i < data->num_moduli; i++) {
+    uint32_t p = data->moduli[i];
 
-    printf("  p=%2u: {", p);
+    printf("  m=%3u: {", p);
     int first = 1;
     for (uint32_t r = 0; r < p; r++) {
       if (get_bit128(data->residue_masks[i], r)) {
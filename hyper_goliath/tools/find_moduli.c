@@ -0,0 +1,353 @@
+/**
+ * Offline search for the strongest sieve moduli of a signature.
+ *
+ * Usage: find_moduli --x X --y Y --z Z [--max M] [--byte N] [--wide N]
+ *                    [--budget KB] [--out FILE]
+ *
+ * For every prime power q <= M this measures the exact survival rate
+ * s(q): the fraction of residue pairs (a, b) mod q, not both divisible by
+ * the prime, with a^x + b^y a z-th power residue mod q. By CRT a modulus
+ * with coprime prime-power factors q_1 q_2 ... survives with probability
+ * s(q_1) s(q_2) ..., and a higher power of a prime subsumes the lower ones,
+ * so any set of moduli has an exact combined survival rate.
+ *
+ * Moduli are then picked greedily. The byte tier (up to MAX_SIEVE_MODULUS)
+ * costs one SIMD lookup per modulus, so each step takes the modulus with
+ * the largest gain -ln(marginal survival). Composites such as 105 pack
+ * several primes into one lookup. The wide tier is checked only on byte-tier
+ * survivors, so its cost is cache footprint. Each step takes the best gain
+ * per table byte, within a budget sized for L2.
+ *
+ * Prints the ranked moduli and writes them (with --out) as a list the engine
+ * loads with --moduli @FILE.
+ */
+
+#include "hyper_goliath.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stop once a modulus would remove less than this much -ln(survival) */
+#define MIN_GAIN 1e-6
+
+typedef struct {
+  uint32_t x, y, z;
+  uint32_t max_modulus; /* Largest candidate M */
+  int byte_count;       /* Byte-tier moduli to pick */
+  int wide_count;       /* Wide-tier moduli to pick */
+  uint32_t budget_kb;   /* Wide-tier table budget */
+  const char *out_path;
+} FindParams;
+
+/**
+ * Count pairs (a, b) mod q with a and b multiples of step (1, or the prime
+ * of q) for which a^x + b^y mod q lies in the residue set res. cx, cy and
+ * the lists are scratch space of q entries.
+ */
+static uint64_t count_survivors(uint32_t q, uint32_t step, const FindParams *fp,
+                                const uint8_t *res, uint32_t *cx, uint32_t *cy,
+                                uint32_t *lx, uint32_t *ly, uint32_t *lres) {
+  memset(cx, 0, q * sizeof(uint32_t));
+  memset(cy, 0, q * sizeof(uint32_t));
+  for (uint32_t a = 0; a < q; a += step) {
+    cx[powmod(a, fp->x, q)]++;
+    cy[powmod(a, fp->y, q)]++;
+  }
+
+  uint32_t nx = 0, ny = 0, nr = 0;
+  for (uint32_t r = 0; r < q; r++) {
+    if (cx[r])
+      lx[nx++] = r;
+    if (cy[r])
+      ly[ny++] = r;
+    if (res[r])
+      lres[nr++] = r;
+  }
+
+  /* Loop over whichever pair of lists is shorter */
+  uint64_t total = 0;
+  if ((uint64_t)ny <= nr) {
+    for (uint32_t i = 0; i < nx; i++) {
+      for (uint32_t j = 0; j < ny; j++) {
+        uint32_t s = lx[i] + ly[j];
+        if (res[s >= q ? s - q : s])
+          total += (uint64_t)cx[lx[i]] * cy[ly[j]];
+      }
+    }
+  } else {
+    for (uint32_t i = 0; i < nx; i++) {
+      for (uint32_t k = 0; k < nr; k++) {
+        uint32_t r = lres[k] + q - lx[i];
+        total += (uint64_t)cx[lx[i]] * cy[r >= q ? r - q : r];
+      }
+    }
+  }
+  return total;
+}
+
+/**
+ * Survival rate of every prime power q <= max (1.0 elsewhere).
+ */
+static double *prime_power_survival(const FindParams *fp,
+                                    const uint32_t *spf) {
+  uint32_t max = fp->max_modulus;
+  double *surv = (double *)malloc((max + 1) * sizeof(double));
+  uint8_t *res = (uint8_t *)malloc(max + 1);
+  uint32_t *scratch = (uint32_t *)malloc(5 * ((size_t)max + 1) *
+                                         sizeof(uint32_t));
+  if (!surv || !res || !scratch) {
+    free(surv);
+    free(res);
+    free(scratch);
+    return NULL;
+  }
+  uint32_t *cx = scratch, *cy = cx + max + 1, *lx = cy + max + 1;
+  uint32_t *ly = lx + max + 1, *lres = ly + max + 1;
+
+  for (uint32_t q = 0; q <= max; q++)
+    surv[q] = 1.0;
+
+  for (uint32_t q = 2; q <= max; q++) {
+    uint32_t p = spf[q], r = q;
+    while (r % p == 0)
+      r /= p;
+    if (r != 1)
+      continue; /* Not a prime power */
+
+    memset(res, 0, q);
+    uint32_t num_res = 0;
+    for (uint32_t c = 0; c < q; c++) {
+      uint32_t v = (uint32_t)powmod(c, fp->z, q);
+      num_res += !res[v];
+      res[v] = 1;
+    }
+    if (num_res == q)
+      continue; /* Every sum is a z-th power: never kills */
+
+    uint64_t all = count_survivors(q, 1, fp, res, cx, cy, lx, ly, lres);
+    uint64_t both = count_survivors(q, p, fp, res, cx, cy, lx, ly, lres);
+    double pairs = (double)q * q - (double)(q / p) * (q / p);
+
+    /* A rate of 0 would rule the signature out entirely; keep logs finite */
+    surv[q] = (double)(all - both) / pairs;
+    if (surv[q] < 1e-300)
+      surv[q] = 1e-300;
+  }
+
+  free(res);
+  free(scratch);
+  return surv;
+}
+
+/**
+ * -ln of the survival rate M adds on top of the prime powers already
+ * covered (power[p] = highest power of p picked so far, 1 if none).
+ */
+static double marginal_gain(uint32_t M, const uint32_t *spf,
+                            const double *surv, const uint32_t *power) {
+  double gain = 0.0;
+  while (M > 1) {
+    uint32_t p = spf[M], q = 1;
+    while (M % p == 0) {
+      M /= p;
+      q *= p;
+    }
+    if (q > power[p])
+      gain += log(surv[power[p]]) - log(surv[q]);
+  }
+  return gain;
+}
+
+/**
+ * Record M's prime powers as covered.
+ */
+static void cover(uint32_t M, const uint32_t *spf, uint32_t *power) {
+  while (M > 1) {
+    uint32_t p = spf[M], q = 1;
+    while (M % p == 0) {
+      M /= p;
+      q *= p;
+    }
+    if (q > power[p])
+      power[p] = q;
+  }
+}
+
+/**
+ * Wide-tier footprint of M: its residue mask plus residue-indexed 16-bit
+ * x-th and y-th power tables, as in the deep bank.
+ */
+static uint32_t wide_bytes(uint32_t M) {
+  return (M + 63) / 64 * 8 + 4 * M;
+}
+
+static void print_usage(const char *prog) {
+  printf("Usage: %s --x X --y Y --z Z [options]\n\n", prog);
+  printf("  --max <M>        Largest modulus to consider (default: 2048,\n");
+  printf("                   up to %d)\n", MAX_WIDE_MODULUS);
+  printf("  --byte <N>       Byte-tier moduli to pick (default: %d, max %d)\n",
+         NUM_SIEVE_PRIMES, MAX_SIEVE_MODULI);
+  printf("  --wide <N>       Wide-tier moduli to pick (default: 16, max %d)\n",
+         MAX_WIDE_MODULI);
+  printf("  --budget <KB>    Wide-tier table budget (default: 256)\n");
+  printf("  --out <file>     Write the list for --moduli @file\n");
+}
+
+int main(int argc, char *argv[]) {
+  FindParams fp = {0, 0, 0, 2048, NUM_SIEVE_PRIMES, 16, 256, NULL};
+
+  static struct option long_options[] = {
+      {"x", required_argument, 0, 'x'},    {"y", required_argument, 0, 'y'},
+      {"z", required_argument, 0, 'z'},    {"max", required_argument, 0, 'M'},
+      {"byte", required_argument, 0, 'n'}, {"wide", required_argument, 0, 'w'},
+      {"budget", required_argument, 0, 'k'},
+      {"out", required_argument, 0, 'o'},  {"help", no_argument, 0, 'h'},
+      {0, 0, 0, 0}};
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "x:y:z:M:n:w:k:o:h", long_options,
+                            NULL)) != -1) {
+    switch (opt) {
+    case 'x':
+      fp.x = (uint32_t)atoi(optarg);
+      break;
+    case 'y':
+      fp.y = (uint32_t)atoi(optarg);
+      break;
+    case 'z':
+      fp.z = (uint32_t)atoi(optarg);
+      break;
+    case 'M':
+      fp.max_modulus = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'n':
+      fp.byte_count = atoi(optarg);
+      break;
+    case 'w':
+      fp.wide_count = atoi(optarg);
+      break;
+    case 'k':
+      fp.budget_kb = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'o':
+      fp.out_path = optarg;
+      break;
+    case 'h':
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (fp.x < 3 || fp.y < 3 || fp.z < 3) {
+    fprintf(stderr, "Error: Exponents x, y, z must all be > 2\n");
+    return 1;
+  }
+  if (fp.max_modulus < 2 || fp.max_modulus > MAX_WIDE_MODULUS ||
+      fp.byte_count < 0 || fp.byte_count > MAX_SIEVE_MODULI ||
+      fp.wide_count < 0 || fp.wide_count > MAX_WIDE_MODULI) {
+    fprintf(stderr, "Error: Option out of range (see --help)\n");
+    return 1;
+  }
+
+  /* Smallest prime factor sieve */
+  uint32_t max = fp.max_modulus;
+  uint32_t *spf = (uint32_t *)calloc(max + 1, sizeof(uint32_t));
+  uint32_t *power = (uint32_t *)malloc((max + 1) * sizeof(uint32_t));
+  if (!spf || !power) {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    return 1;
+  }
+  for (uint32_t i = 2; i <= max; i++) {
+    if (spf[i])
+      continue;
+    for (uint32_t j = i; j <= max; j += i) {
+      if (!spf[j])
+        spf[j] = i;
+    }
+  }
+  for (uint32_t i = 0; i <= max; i++)
+    power[i] = 1;
+
+  double *surv = prime_power_survival(&fp, spf);
+  if (!surv) {
+    fprintf(stderr, "ERROR: Out of memory\n");
+    return 1;
+  }
+
+  /* Reference: the sacred 20 primes */
+  double sacred = 0.0;
+  for (int i = 0; i < NUM_SIEVE_PRIMES && SIEVE_PRIMES[i] <= max; i++)
+    sacred += log(surv[SIEVE_PRIMES[i]]);
+
+  printf("Obstruction moduli for (%u, %u, %u), M <= %u\n\n", fp.x, fp.y, fp.z,
+         max);
+  printf("  rank  modulus  tier  kill%%     survival    bytes\n");
+
+  uint32_t picked[MAX_MODULI_LIST];
+  int num_picked = 0;
+  double log_surv = 0.0;
+  uint32_t wide_used = 0;
+
+  for (int tier = 0; tier < 2; tier++) {
+    uint32_t lo = tier ? MAX_SIEVE_MODULUS + 1 : 2;
+    uint32_t hi = !tier && max > MAX_SIEVE_MODULUS ? MAX_SIEVE_MODULUS : max;
+    int quota = tier ? fp.wide_count : fp.byte_count;
+
+    for (int n = 0; n < quota; n++) {
+      uint32_t best = 0;
+      double best_gain = 0.0, best_score = 0.0;
+      for (uint32_t M = lo; M <= hi; M++) {
+        if (tier && wide_used + wide_bytes(M) > fp.budget_kb * 1024)
+          continue;
+        double gain = marginal_gain(M, spf, surv, power);
+        double score = tier ? gain / wide_bytes(M) : gain;
+        if (gain >= MIN_GAIN && score > best_score) {
+          best = M;
+          best_gain = gain;
+          best_score = score;
+        }
+      }
+      if (!best)
+        break;
+
+      cover(best, spf, power);
+      log_surv -= best_gain;
+      uint32_t bytes = tier ? wide_bytes(best) : 16;
+      wide_used += tier ? bytes : 0;
+      picked[num_picked++] = best;
+      printf("  %4d  %7u  %-4s  %6.2f  %11.4e  %7u\n", num_picked, best,
+             tier ? "wide" : "byte", 100.0 * (1.0 - exp(-best_gain)),
+             exp(log_surv), bytes);
+    }
+  }
+
+  printf("\nSurvival: %.4e (sacred 20 primes: %.4e, %.3gx fewer survivors)\n",
+         exp(log_surv), exp(sacred), exp(sacred - log_surv));
+  printf("Wide-tier tables: %u bytes\n\n--moduli ", wide_used);
+  for (int i = 0; i < num_picked; i++)
+    printf("%s%u", i ? "," : "", picked[i]);
+  printf("\n");
+
+  if (fp.out_path) {
+    FILE *f = fopen(fp.out_path, "w");
+    if (!f) {
+      fprintf(stderr, "ERROR: Cannot write %s\n", fp.out_path);
+      return 1;
+    }
+    fprintf(f, "# find_moduli (%u, %u, %u), M <= %u: survival %.4e\n", fp.x,
+            fp.y, fp.z, max, exp(log_surv));
+    for (int i = 0; i < num_picked; i++)
+      fprintf(f, "%s%u", i ? "," : "", picked[i]);
+    fprintf(f, "\n");
+    fclose(f);
+  }
+
+  free(spf);
+  free(power);
+  free(surv);
+  return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * Build-time generator for signature-specialized sieve kernels.
+ *
+ * Usage: gen_kernels <output.c> [x,y,z ...]
+ *
+ * For each signature, emits a fully unrolled per-pair test over the sacred
+ * 20 primes with every modulus, power table and residue mask baked in as a
+ * constant, so A % p and B % p compile to multiply-shift sequences. Primes
+ * whose residue set covers every sum can never kill and are left out; the
+ * rest are ordered by their exact kill probability, highest first.
+ * Also emits sieve_kernel_lookup() over the generated signatures.
+ */
+
+#include "hyper_goliath.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  uint32_t p;
+  uint64_t mask[2];
+  double kill;
+} PrimeInfo;
+
+static int by_kill_desc(const void *a, const void *b) {
+  const PrimeInfo *pa = (const PrimeInfo *)a;
+  const PrimeInfo *pb = (const PrimeInfo *)b;
+  if (pa->kill != pb->kill)
+    return pa->kill < pb->kill ? 1 : -1;
+  return pa->p < pb->p ? -1 : 1;
+}
+
+static void emit_table(FILE *f, const char *name, uint32_t p, uint32_t e) {
+  fprintf(f, "static const uint8_t %s[%u] = {", name, p);
+  for (uint32_t r = 0; r < p; r++)
+    fprintf(f, "%s%s%u", r ? "," : "", r % 16 ? "" : "\n    ",
+            (uint32_t)powmod(r, e, p));
+  fprintf(f, "};\n");
+}
+
+static void emit_signature(FILE *f, uint32_t x, uint32_t y, uint32_t z) {
+  PrimeInfo info[NUM_SIEVE_PRIMES];
+  int n = 0;
+
+  for (int i = 0; i < NUM_SIEVE_PRIMES; i++) {
+    uint32_t p = SIEVE_PRIMES[i];
+    PrimeInfo pi = {p, {0, 0}, 0.0};
+    for (uint32_t r = 0; r < p; r++)
+      set_bit128(pi.mask, (uint32_t)powmod(r, z, p));
+
+    uint32_t killed = 0;
+    for (uint32_t a = 0; a < p; a++) {
+      for (uint32_t b = 0; b < p; b++) {
+        uint32_t s = (uint32_t)((powmod(a, x, p) + powmod(b, y, p)) % p);
+        killed += !get_bit128(pi.mask, s);
+      }
+    }
+    if (!killed)
+      continue; /* Never kills for this signature */
+    pi.kill = (double)killed / ((double)p * p);
+    info[n++] = pi;
+  }
+  qsort(info, (size_t)n, sizeof(PrimeInfo), by_kill_desc);
+
+  fprintf(f, "\n/* (%u, %u, %u): %d of %d primes can kill */\n", x, y, z, n,
+          NUM_SIEVE_PRIMES);
+  for (int k = 0; k < n; k++) {
+    char name[64];
+    snprintf(name, sizeof(name), "AX_%u_%u_%u_%u", x, y, z, info[k].p);
+    emit_table(f, name, info[k].p, x);
+    snprintf(name, sizeof(name), "BY_%u_%u_%u_%u", x, y, z, info[k].p);
+    emit_table(f, name, info[k].p, y);
+  }
+
+  fprintf(f, "\nstatic bool survives_%u_%u_%u(uint64_t A, uint64_t B) {\n",
+          x, y, z);
+  fprintf(f, "  uint32_t r;\n");
+  for (int k = 0; k < n; k++) {
+    uint32_t p = info[k].p;
+    fprintf(f, "\n  /* p = %u, kills %.1f%% */\n", p, 100.0 * info[k].kill);
+    fprintf(f, "  r = AX_%u_%u_%u_%u[A %% %u] + BY_%u_%u_%u_%u[B %% %u];\n", x,
+            y, z, p, p, x, y, z, p, p);
+    fprintf(f, "  r -= r >= %u ? %u : 0;\n", p, p);
+    if (p <= 64) {
+      fprintf(f, "  if (!((0x%016llxULL >> r) & 1))\n",
+              (unsigned long long)info[k].mask[0]);
+    } else {
+      fprintf(f,
+              "  if (!((r < 64 ? 0x%016llxULL >> r\n"
+              "                : 0x%016llxULL >> (r - 64)) & 1))\n",
+              (unsigned long long)info[k].mask[0],
+              (unsigned long long)info[k].mask[1]);
+    }
+    fprintf(f, "    return false;\n");
+  }
+  fprintf(f, "  return true;\n}\n");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <output.c> [x,y,z ...]\n", argv[0]);
+    return 1;
+  }
+
+  uint32_t sigs[64][3];
+  int num_sigs = 0;
+  for (int a = 2; a < argc; a++) {
+    unsigned x, y, z;
+    if (sscanf(argv[a], "%u,%u,%u", &x, &y, &z) != 3 || x < 3 || y < 3 ||
+        z < 3 || num_sigs == 64) {
+      fprintf(stderr, "ERROR: Bad signature '%s'\n", argv[a]);
+      return 1;
+    }
+    sigs[num_sigs][0] = x;
+    sigs[num_sigs][1] = y;
+    sigs[num_sigs][2] = z;
+    num_sigs++;
+  }
+
+  FILE *f = fopen(argv[1], "w");
+  if (!f) {
+    fprintf(stderr, "ERROR: Cannot write %s\n", argv[1]);
+    return 1;
+  }
+
+  fprintf(f, "/**\n * Signature-specialized sieve kernels.\n"
+             " * Generated by tools/gen_kernels.c - do not edit.\n */\n\n"
+             "#include \"hyper_goliath.h\"\n");
+  for (int s = 0; s < num_sigs; s++)
+    emit_signature(f, sigs[s][0], sigs[s][1], sigs[s][2]);
+
+  fprintf(f, "\nSieveKernelFn sieve_kernel_lookup(uint32_t x, uint32_t y, "
+             "uint32_t z) {\n");
+  for (int s = 0; s < num_sigs; s++) {
+    fprintf(f, "  if (x == %u && y == %u && z == %u)\n", sigs[s][0],
+            sigs[s][1], sigs[s][2]);
+    fprintf(f, "    return survives_%u_%u_%u;\n", sigs[s][0], sigs[s][1],
+            sigs[s][2]);
+  }
+  fprintf(f, "  (void)x;\n  (void)y;\n  (void)z;\n  return NULL;\n}\n");
+
+  fclose(f);
+  return 0;
+}